@@ -0,0 +1,211 @@
+/**
+ * AllocStats Implementation File
+ *
+ * Implements the counting allocation hooks and the per-operation totals.
+ */
+
+#include "allocstats.h"
+#include <QStringList>
+#include <atomic>
+#include <cstdlib>
+#include <cstdint>
+#include <cerrno>
+#include <new>
+#if defined(TIMETABLE_ALLOC_STATS) && defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+const int OperationSlots = static_cast<int>(AllocOperation::OperationCount);
+
+// trivially initialised, so they are safe to touch from inside malloc
+thread_local qint64 threadAllocationCount = 0;
+thread_local qint64 threadByteCount = 0;
+
+struct OperationSlot {
+    std::atomic<qint64> calls{0};
+    std::atomic<qint64> allocations{0};
+    std::atomic<qint64> bytes{0};
+};
+
+OperationSlot operationSlots[OperationSlots];
+
+const char *const OperationNames[OperationSlots] = {
+    "add course", "refresh table", "generate", "flip page", "save image"
+};
+
+inline void countAllocation(std::size_t size)
+{
+    threadAllocationCount++;
+    threadByteCount += qint64(size);
+}
+
+} // namespace
+
+#ifdef TIMETABLE_ALLOC_STATS
+
+#if defined(__GLIBC__)
+// glibc: hook the malloc family itself. Qt containers and strings allocate
+// with malloc, not operator new, and operator new goes through malloc too,
+// so this sees everything exactly once.
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *pointer, std::size_t size);
+void *__libc_memalign(std::size_t alignment, std::size_t size);
+void *__libc_valloc(std::size_t size);
+
+void *malloc(std::size_t size)
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size)
+{
+    // an overflowing request fails in glibc, so there is nothing to count
+    if (size == 0 || count <= SIZE_MAX / size) countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+// Only growth is new memory: a shrink or an in-place fit counts nothing
+void *realloc(void *pointer, std::size_t size)
+{
+    if (!pointer) {
+        countAllocation(size);
+    } else {
+        const std::size_t usable = malloc_usable_size(pointer);
+        if (size > usable) countAllocation(size - usable);
+    }
+    return __libc_realloc(pointer, size);
+}
+
+// Aligned allocations (aligned operator new, SIMD buffers) all end up in
+// memalign; glibc exports no __libc_ form of the other two
+void *memalign(std::size_t alignment, std::size_t size)
+{
+    countAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(std::size_t alignment, std::size_t size)
+{
+    countAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **result, std::size_t alignment, std::size_t size)
+{
+    if (alignment == 0 || alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void *pointer = __libc_memalign(alignment, size);
+    if (!pointer) return ENOMEM;
+
+    countAllocation(size);
+    *result = pointer;
+    return 0;
+}
+
+void *valloc(std::size_t size)
+{
+    countAllocation(size);
+    return __libc_valloc(size);
+}
+}
+#else
+// Elsewhere only operator new can be replaced portably: widgets, QObjects
+// and engine nodes are counted. Qt's container, string and stylesheet
+// buffers are allocated inside the Qt DLLs and are not (see isComplete())
+void *operator new(std::size_t size)
+{
+    countAllocation(size);
+    if (void *pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+#endif
+
+#endif // TIMETABLE_ALLOC_STATS
+
+bool AllocStats::isComplete()
+{
+#if defined(TIMETABLE_ALLOC_STATS) && defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+qint64 AllocStats::threadAllocations()
+{
+    return threadAllocationCount;
+}
+
+qint64 AllocStats::threadBytes()
+{
+    return threadByteCount;
+}
+
+void AllocStats::addOperation(AllocOperation operation, qint64 allocations, qint64 bytes)
+{
+    OperationSlot &slot = operationSlots[static_cast<int>(operation)];
+    slot.calls.fetch_add(1, std::memory_order_relaxed);
+    slot.allocations.fetch_add(allocations, std::memory_order_relaxed);
+    slot.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+// e.g. "alloc refresh table      calls 12  allocs/op 4210  bytes/op 391220"
+// (stable field names, so CI logs can be compared with a script). Where
+// only operator new is hooked the counts are partial: they are marked as
+// such and bytes/op is left out, so no one mistakes them for the total.
+QString AllocStats::summary()
+{
+    const bool complete = isComplete();
+
+    QStringList lines;
+    if (!complete) {
+        lines.append("alloc incomplete: only operator new is counted on this platform, "
+                     "not Qt's container, string or stylesheet buffers");
+    }
+    for (int i = 0; i < OperationSlots; ++i) {
+        const qint64 calls = operationSlots[i].calls.load(std::memory_order_relaxed);
+        if (calls == 0) continue;
+
+        QString line = QString("alloc %1 calls %2  %3 %4")
+                           .arg(QString::fromLatin1(OperationNames[i]), -15)
+                           .arg(calls, 5)
+                           .arg(QLatin1String(complete ? "allocs/op" : "new/op"))
+                           .arg(operationSlots[i].allocations.load(std::memory_order_relaxed) / calls, 8);
+        if (complete) {
+            line += QString("  bytes/op %1").arg(operationSlots[i].bytes.load(std::memory_order_relaxed) / calls, 10);
+        }
+        lines.append(line);
+    }
+    return lines.join('\n');
+}
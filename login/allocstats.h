@@ -0,0 +1,92 @@
+/**
+ * AllocStats Header File
+ *
+ * This file defines allocation accounting for the operations that
+ * allocate the most (adding a course, rebuilding the course table,
+ * generating, paging, saving an image).
+ *
+ * Build with "qmake CONFIG+=alloc_stats" to install counting allocation
+ * hooks. In a normal build nothing is hooked and ALLOC_SCOPE expands to
+ * ((void)0), an empty statement.
+ */
+
+#ifndef ALLOCSTATS_H
+#define ALLOCSTATS_H
+
+#include <QString>
+
+enum class AllocOperation {
+    AddCourse,
+    RefreshTable,
+    Generate,
+    FlipPage,
+    SaveImage,
+
+    OperationCount
+};
+
+/**
+ * AllocStats Class
+ *
+ * The hooks count allocations and requested bytes per thread (plain
+ * thread_local counters, no atomics), so an operation only sees its own
+ * thread's allocations, even while workers are busy. Finished operations
+ * are added to one shared slot per operation.
+ */
+class AllocStats {
+public:
+    /**
+     * true if every allocation is seen (glibc, where the malloc family is
+     * hooked); elsewhere only operator new is, and summary() says so
+     */
+    static bool isComplete();
+
+    /**
+     * Allocations and bytes made so far by the calling thread
+     */
+    static qint64 threadAllocations();
+    static qint64 threadBytes();
+
+    static void addOperation(AllocOperation operation, qint64 allocations, qint64 bytes);
+
+    /**
+     * One line per operation seen: count, allocations and bytes per call
+     * (bytes only when isComplete())
+     */
+    static QString summary();
+};
+
+/**
+ * Charges the calling thread's allocations in this scope to an operation
+ */
+class AllocScope {
+public:
+    explicit AllocScope(AllocOperation operation)
+        : operation(operation)
+        , startAllocations(AllocStats::threadAllocations())
+        , startBytes(AllocStats::threadBytes()) {}
+    ~AllocScope()
+    {
+        AllocStats::addOperation(operation, AllocStats::threadAllocations() - startAllocations,
+                                 AllocStats::threadBytes() - startBytes);
+    }
+
+    AllocScope(const AllocScope &) = delete;
+    AllocScope &operator=(const AllocScope &) = delete;
+
+private:
+    AllocOperation operation;
+    qint64 startAllocations;
+    qint64 startBytes;
+};
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+
+#ifdef TIMETABLE_ALLOC_STATS
+#define ALLOC_SCOPE(operation) AllocScope ALLOC_CONCAT(allocScope, __LINE__)(operation)
+#else
+#define ALLOC_SCOPE(operation) ((void)0)
+#endif
+
+#endif // ALLOCSTATS_H
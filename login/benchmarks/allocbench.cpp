@@ -0,0 +1,189 @@
+/**
+ * Allocation Benchmark
+ *
+ * Runs each operation that AllocStats accounts for a fixed number of
+ * times, on the offscreen platform so no display is needed (CI):
+ * - add course: typed into ManageCoursesPage and added with its button
+ * - refresh table: the course table rebuilt for a whole session
+ * - generate: TIMETABLE::setCoursesData()
+ * - flip page: TIMETABLE's next/previous buttons, forwards over new
+ *   pages and back over cached ones
+ * - save image: the Save As worker's rendering, on the current page
+ *
+ * The first four go through the instrumented code of the app itself, so
+ * the numbers are the app's; save image is timed around the same
+ * TimetableRenderer calls, because Save As needs a file dialog. The
+ * output is AllocStats::summary(): one "alloc ..." line per operation.
+ */
+
+#include "managecoursespage.h"
+#include "timetable.h"
+#include "timetableengine.h"
+#include "timetablerenderer.h"
+#include "sessionmanager.h"
+#include "allocstats.h"
+#include <QApplication>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QTimer>
+#include <QDir>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+const int CourseCount = 8;        // courses added, each with SectionsPerCourse sections
+const int SectionsPerCourse = 3;
+const int RefreshRounds = 20;
+const int GenerateRounds = 5;
+const int FlipsEachWay = 100;
+const int SaveRounds = 5;
+const qreal SaveDpi = 192.0;      // same as TIMETABLE's Save As
+
+const char *const Days[] = { "Monday", "Tuesday", "Wednesday", "Thursday", "Friday" };
+
+// Spread over the week with some overlaps, so there are many pages and
+// some combinations conflict
+Course sectionFor(int course, int section)
+{
+    static const char *const Starts[] = { "8am", "9am", "10am", "11am", "1pm", "2pm", "3pm" };
+    static const char *const Ends[] = { "10am", "11am", "12pm", "1pm", "3pm", "4pm", "5pm" };
+
+    const int slot = (course * 2 + section * 3) % 7;
+    Course result;
+    result.name = QString("Course %1").arg(course + 1);
+    result.day = Days[(course + section) % 5];
+    result.startTime = Starts[slot];
+    result.endTime = Ends[slot];
+    result.classroom = QString("Room %1").arg(100 + course * 10 + section);
+    return result;
+}
+
+template <typename T>
+T *child(QWidget *parent, const char *name)
+{
+    T *widget = parent->findChild<T *>(name);
+    if (!widget) {
+        std::fprintf(stderr, "allocbench: widget %s not found\n", name);
+        std::exit(1);
+    }
+    return widget;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // no display needed unless one is asked for
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("allocbench");
+
+    // journals go to a throwaway test location, emptied before and after
+    QStandardPaths::setTestModeEnabled(true);
+    QDir dataDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    dataDir.removeRecursively();
+
+    QTemporaryDir outputDir;
+    if (!outputDir.isValid()) {
+        std::fprintf(stderr, "allocbench: cannot create a temporary directory\n");
+        return 1;
+    }
+
+    QSharedPointer<StudentSession> session = QSharedPointer<StudentSession>::create();
+    session->studentID = "allocbench";
+    if (!session->store.open(session->studentID, session->courses)) {
+        std::fprintf(stderr, "allocbench: %s\n", qPrintable(session->store.errorString()));
+        return 1;
+    }
+
+    // The app confirms every added course with a message box: close each
+    // one as soon as its event loop runs
+    QTimer dismissTimer;
+    dismissTimer.setInterval(0);
+    QObject::connect(&dismissTimer, &QTimer::timeout, []() {
+        if (QMessageBox *box = qobject_cast<QMessageBox *>(QApplication::activeModalWidget())) {
+            box->accept();
+        }
+    });
+    dismissTimer.start();
+
+    {
+        ManageCoursesPage page;
+        page.setSession(session);
+        page.show();
+
+        QLineEdit *nameInput = child<QLineEdit>(&page, "courseNameInput");
+        QLineEdit *classroomInput = child<QLineEdit>(&page, "classroomInput");
+        QComboBox *dayCombo = child<QComboBox>(&page, "dayCombo");
+        QComboBox *startCombo = child<QComboBox>(&page, "startTimeLabel");
+        QComboBox *endCombo = child<QComboBox>(&page, "endTimeInput");
+        QPushButton *addButton = child<QPushButton>(&page, "addCourseBtn");
+
+        for (int course = 0; course < CourseCount; ++course) {
+            for (int section = 0; section < SectionsPerCourse; ++section) {
+                const Course input = sectionFor(course, section);
+                nameInput->setText(input.name);
+                classroomInput->setText(input.classroom);
+                dayCombo->setCurrentText(input.day);
+                startCombo->setCurrentText(input.startTime);
+                endCombo->setCurrentText(input.endTime);
+                addButton->click();
+            }
+        }
+        if (session->courses.size() != CourseCount * SectionsPerCourse) {
+            std::fprintf(stderr, "allocbench: only %d courses were added\n", int(session->courses.size()));
+            return 1;
+        }
+
+        // setSession() rebuilds the whole table
+        for (int i = 0; i < RefreshRounds; ++i) {
+            page.setSession(session);
+        }
+    }
+    dismissTimer.stop();
+
+    {
+        TIMETABLE window;
+        for (int i = 0; i < GenerateRounds; ++i) {
+            window.setCoursesData(session->courses);
+        }
+
+        QPushButton *nextButton = child<QPushButton>(&window, "nextPageBtn");
+        QPushButton *prevButton = child<QPushButton>(&window, "prevPageBtn");
+        for (int i = 0; i < FlipsEachWay; ++i) {
+            nextButton->click();
+            QApplication::processEvents();  // let each page paint
+        }
+        for (int i = 0; i < FlipsEachWay; ++i) {
+            prevButton->click();
+            QApplication::processEvents();
+        }
+    }
+
+    // Save As without its file dialog: the same rendering the worker does
+    TimetableEngine engine;
+    engine.setCourses(session->courses);
+    const QVector<Course> pageCourses = engine.combinationAt(0);
+    for (int i = 0; i < SaveRounds; ++i) {
+        const QString fileName = QDir(outputDir.path()).filePath(QString("page%1.png").arg(i));
+        ALLOC_SCOPE(AllocOperation::SaveImage);
+        QImage image = TimetableRenderer::renderImage(pageCourses, SaveDpi);
+        if (!image.save(fileName)) {
+            std::fprintf(stderr, "allocbench: cannot write %s\n", qPrintable(fileName));
+            return 1;
+        }
+    }
+
+    session->store.close();
+    dataDir.removeRecursively();
+
+    std::printf("%s\n", qPrintable(AllocStats::summary()));
+    return 0;
+}
@@ -0,0 +1,16 @@
+# Allocations per operation, headless (console program, not part of the app):
+#   qmake allocbench.pro && make && ./allocbench
+# Runs the real course page and timetable window on the offscreen platform
+# and prints AllocStats::summary(), one "alloc ..." line per operation.
+
+CONFIG += alloc_stats
+include(../login.pri)
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = allocbench
+TEMPLATE = app
+
+SOURCES += \
+    allocbench.cpp
@@ -0,0 +1,121 @@
+/**
+ * Login Benchmark
+ *
+ * Fills a UserStore with 100k accounts (or the number given on the
+ * command line), then times the steps of MainWindow::validateLogin():
+ * loading the account file, looking up a student ID and checking the
+ * password. Lookup must stay flat as the store grows; the password check
+ * is slow on purpose and should not depend on the number of accounts.
+ */
+
+#include "userstore.h"
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QVector>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const int DefaultAccounts = 100000;
+const int LookupRounds = 1000000;
+const int LoginSamples = 20;
+
+QString studentID(int index)
+{
+    return QString::number(20000000 + index);
+}
+
+// e.g. "correct password      min 98.12 ms  median 99.40 ms  max 103.77 ms"
+void printSamples(const char *label, QVector<double> samplesMs)
+{
+    std::sort(samplesMs.begin(), samplesMs.end());
+    std::printf("%-22s min %.2f ms  median %.2f ms  max %.2f ms\n", label,
+                samplesMs.first(), samplesMs[samplesMs.size() / 2], samplesMs.last());
+}
+
+// One login as validateLogin() does it: index lookup, then the hash check
+template <typename Pick>
+QVector<double> timeLogins(const UserStore &store, const QString &password, Pick pickID)
+{
+    QVector<double> samplesMs;
+    for (int i = 0; i < LoginSamples; ++i) {
+        const QString id = pickID();
+
+        QElapsedTimer timer;
+        timer.start();
+        const bool accepted = UserStore::verify(store.credential(id), password);
+        samplesMs.append(timer.nsecsElapsed() / 1e6);
+
+        if (accepted != (password == "password123" && store.contains(id))) {
+            std::fprintf(stderr, "unexpected result for %s\n", qPrintable(id));
+        }
+    }
+    return samplesMs;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int accounts = argc > 1 ? qMax(1, QString(argv[1]).toInt()) : DefaultAccounts;
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        std::fprintf(stderr, "Cannot create a temporary directory\n");
+        return 1;
+    }
+    const QString fileName = dir.filePath("users.db");
+
+    // Every account gets the same (real strength) credential: hashing 100k
+    // distinct passwords would take hours and measures nothing new
+    const Credential credential = UserStore::makeCredential("password123");
+
+    QElapsedTimer timer;
+    timer.start();
+    {
+        UserStore store(fileName);
+        store.open();
+        for (int i = 0; i < accounts; ++i) {
+            if (!store.addUser(studentID(i), credential)) {
+                std::fprintf(stderr, "%s\n", qPrintable(store.errorString()));
+                return 1;
+            }
+        }
+    }
+    std::printf("registered %d accounts  %.2f s  (%.1f us per append)\n", accounts,
+                timer.nsecsElapsed() / 1e9, timer.nsecsElapsed() / 1e3 / accounts);
+
+    // Startup: the account file is read once
+    UserStore store(fileName);
+    timer.restart();
+    if (!store.open()) {
+        std::fprintf(stderr, "%s\n", qPrintable(store.errorString()));
+        return 1;
+    }
+    std::printf("open (%d accounts)     %.2f ms\n", store.size(), timer.nsecsElapsed() / 1e6);
+
+    // Index lookup alone, over random IDs
+    QVector<QString> ids;
+    ids.reserve(1024);
+    for (int i = 0; i < 1024; ++i) ids.append(studentID(QRandomGenerator::global()->bounded(accounts)));
+
+    int found = 0;
+    timer.restart();
+    for (int i = 0; i < LookupRounds; ++i) {
+        found += store.credential(ids[i & 1023]).isValid() ? 1 : 0;
+    }
+    std::printf("lookup                 %.1f ns  (%d found)\n",
+                double(timer.nsecsElapsed()) / LookupRounds, found);
+
+    auto randomID = [accounts]() { return studentID(QRandomGenerator::global()->bounded(accounts)); };
+    auto unknownID = [accounts]() { return studentID(accounts + QRandomGenerator::global()->bounded(accounts)); };
+
+    printSamples("correct password", timeLogins(store, "password123", randomID));
+    printSamples("wrong password", timeLogins(store, "password124", randomID));
+    printSamples("unknown student ID", timeLogins(store, "password123", unknownID));
+    return 0;
+}
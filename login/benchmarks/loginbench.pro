@@ -0,0 +1,19 @@
+# Login latency at 100k accounts (console program, not part of the app):
+#   qmake loginbench.pro && make && ./loginbench [accounts]
+
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = loginbench
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    loginbench.cpp \
+    ../userstore.cpp
+
+HEADERS += \
+    ../userstore.h
@@ -0,0 +1,142 @@
+/**
+ * ClashAnalyzer Implementation File
+ *
+ * Implements the overlap search and bitset co-enrollment counts.
+ */
+
+#include "clashanalyzer.h"
+#include "timetableengine.h"
+#include "managecoursespage.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtAlgorithms>
+#include <algorithm>
+
+namespace {
+
+// A course pair whose sections overlap somewhere
+struct CoursePair {
+    int courseA;
+    int courseB;
+    int students = 0;
+};
+
+// Same hour mask TimetableEngine builds; 0 for invalid sections
+quint16 sectionMask(const Course &section)
+{
+    const int start = TimetableEngine::hourIndex(section.startTime);
+    const int end = TimetableEngine::hourIndex(section.endTime);
+    if (start < 0 || end < 0 || start >= end) return 0;
+    return quint16(((1u << end) - 1) & ~((1u << start) - 1));
+}
+
+} // namespace
+
+ClashReport ClashAnalyzer::analyze(const QVector<Course> &sections,
+                                   const QVector<QStringList> &enrollments)
+{
+    ClashReport report;
+
+    courseIndex.clear();
+    QVector<int> sectionCourse(sections.size());
+    for (int i = 0; i < sections.size(); ++i) {
+        auto it = courseIndex.constFind(sections[i].name);
+        if (it == courseIndex.constEnd()) {
+            it = courseIndex.insert(sections[i].name, courseIndex.size());
+        }
+        sectionCourse[i] = it.value();
+    }
+    report.courseCount = courseIndex.size();
+
+    buildEnrollment(enrollments);
+
+    // Sections by day, so only same-day sections are compared
+    QVector<int> byDay[TimetableEngine::DayCount];
+    QVector<quint16> masks(sections.size());
+    for (int i = 0; i < sections.size(); ++i) {
+        const int day = TimetableEngine::dayIndex(sections[i].day);
+        masks[i] = sectionMask(sections[i]);
+        if (day >= 0 && masks[i]) byDay[day].append(i);
+    }
+
+    // Overlapping sections of different courses, one entry per course pair
+    QVector<SectionClash> overlaps;
+    QVector<int> overlapPair;
+    QVector<CoursePair> coursePairs;
+    QHash<quint64, int> pairIndex;
+
+    for (const QVector<int> &day : byDay) {
+        for (int x = 0; x < day.size(); ++x) {
+            for (int y = x + 1; y < day.size(); ++y) {
+                const int a = day[x];
+                const int b = day[y];
+                if (!(masks[a] & masks[b])) continue;
+
+                const int courseA = qMin(sectionCourse[a], sectionCourse[b]);
+                const int courseB = qMax(sectionCourse[a], sectionCourse[b]);
+                if (courseA == courseB) continue;
+
+                const quint64 key = (quint64(courseA) << 32) | quint32(courseB);
+                auto it = pairIndex.constFind(key);
+                if (it == pairIndex.constEnd()) {
+                    it = pairIndex.insert(key, coursePairs.size());
+                    coursePairs.append({ courseA, courseB });
+                }
+                overlaps.append({ qMin(a, b), qMax(a, b), 0 });
+                overlapPair.append(it.value());
+            }
+        }
+    }
+    report.coursePairsChecked = coursePairs.size();
+
+    // The expensive part: one bitset AND + popcount per course pair
+    QtConcurrent::blockingMap(coursePairs, [this](CoursePair &pair) {
+        pair.students = coEnrollment(pair.courseA, pair.courseB);
+    });
+
+    for (int i = 0; i < overlaps.size(); ++i) {
+        overlaps[i].students = coursePairs[overlapPair[i]].students;
+        if (overlaps[i].students > 0) report.clashes.append(overlaps[i]);
+    }
+    std::stable_sort(report.clashes.begin(), report.clashes.end(),
+                     [](const SectionClash &a, const SectionClash &b) {
+                         return a.students > b.students;
+                     });
+
+    // Students in both courses of any clashing pair
+    QVector<quint64> affected(wordsPerCourse, 0);
+    for (const CoursePair &pair : coursePairs) {
+        if (pair.students == 0) continue;
+        const quint64 *a = studentBits.constData() + qsizetype(pair.courseA) * wordsPerCourse;
+        const quint64 *b = studentBits.constData() + qsizetype(pair.courseB) * wordsPerCourse;
+        for (int w = 0; w < wordsPerCourse; ++w) affected[w] |= a[w] & b[w];
+    }
+    for (quint64 word : affected) report.sharedEnrollment += qPopulationCount(word);
+
+    return report;
+}
+
+// One bit per student in each course's row; courses not on offer are ignored
+void ClashAnalyzer::buildEnrollment(const QVector<QStringList> &enrollments)
+{
+    wordsPerCourse = int((enrollments.size() + 63) / 64);
+    studentBits.fill(0, qsizetype(courseIndex.size()) * wordsPerCourse);
+
+    for (int student = 0; student < enrollments.size(); ++student) {
+        for (const QString &name : enrollments[student]) {
+            auto it = courseIndex.constFind(name);
+            if (it == courseIndex.constEnd()) continue;
+            studentBits[qsizetype(it.value()) * wordsPerCourse + student / 64] |=
+                quint64(1) << (student % 64);
+        }
+    }
+}
+
+int ClashAnalyzer::coEnrollment(int courseA, int courseB) const
+{
+    const quint64 *a = studentBits.constData() + qsizetype(courseA) * wordsPerCourse;
+    const quint64 *b = studentBits.constData() + qsizetype(courseB) * wordsPerCourse;
+
+    int count = 0;
+    for (int w = 0; w < wordsPerCourse; ++w) count += qPopulationCount(a[w] & b[w]);
+    return count;
+}
@@ -0,0 +1,72 @@
+/**
+ * ClashAnalyzer Header File
+ *
+ * This file defines the department-wide clash analysis: given every
+ * student's selected courses, it finds the section placements that
+ * would force students into two classes at once.
+ */
+
+#ifndef CLASHANALYZER_H
+#define CLASHANALYZER_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+
+struct Course;  // Forward declaration
+
+/**
+ * Two sections of different courses that overlap in time, and how many
+ * students take both courses (whichever sections they end up in)
+ */
+struct SectionClash {
+    int first;     // Section indexes, first < second
+    int second;
+    int students;
+};
+
+struct ClashReport {
+    QVector<SectionClash> clashes;  // Most students first
+    int courseCount = 0;
+    int coursePairsChecked = 0;     // Course pairs with overlapping sections
+
+    /**
+     * Students enrolled in both courses of at least one overlapping
+     * section pair. Enrollments name courses, not sections, so this is an
+     * upper bound: some of them may have picked sections that don't overlap.
+     */
+    int sharedEnrollment = 0;
+};
+
+/**
+ * ClashAnalyzer Class
+ *
+ * Each course keeps its enrolled students as a bitset (one bit per
+ * student), so the number of students taking two courses is the popcount
+ * of the AND of their bitsets - the co-enrollment matrix is never built in
+ * full. Only course pairs with overlapping sections are looked at, and
+ * those are counted in parallel with QtConcurrent.
+ *
+ * Sections use the same day/hour masks as TimetableEngine. Sections of
+ * the same course never clash: a student only attends one of them.
+ */
+class ClashAnalyzer {
+public:
+    /**
+     * @param sections: Every section on offer; the course is Course::name
+     * @param enrollments: Course names selected by each student
+     */
+    ClashReport analyze(const QVector<Course> &sections,
+                        const QVector<QStringList> &enrollments);
+
+private:
+    void buildEnrollment(const QVector<QStringList> &enrollments);
+    int coEnrollment(int courseA, int courseB) const;
+
+    QHash<QString, int> courseIndex;  // Course name -> bitset row
+    QVector<quint64> studentBits;     // courseCount rows of wordsPerCourse words
+    int wordsPerCourse = 0;
+};
+
+#endif // CLASHANALYZER_H
@@ -0,0 +1,345 @@
+/**
+ * CourseStore Implementation File
+ *
+ * Implements the per-student course journal: record framing, replay,
+ * crash recovery and compaction.
+ */
+
+#include "coursestore.h"
+#include "managecoursespage.h"
+#include <QDataStream>
+#include <QSaveFile>
+#include <QDir>
+#include <QStandardPaths>
+
+namespace {
+
+const quint32 JournalMagic = 0x43544A31;  // "CTJ1"
+const quint16 JournalVersion = 1;
+const int HeaderSize = 6;                 // magic + version
+const int StreamVersion = QDataStream::Qt_6_0;  // fixed, so files read the same with any Qt 6
+
+// a journal is compacted once it holds this many records and more than
+// twice as many records as there are courses
+const int CompactMinRecords = 64;
+const int CompactRatio = 2;
+
+// record frame: payload size, checksum, payload
+const int FrameHeaderSize = 6;
+const quint32 MaxPayloadSize = 64 * 1024;  // anything bigger is a damaged frame
+
+void writeCourse(QDataStream &out, const Course &course)
+{
+    out << course.name << course.day << course.startTime << course.endTime
+        << course.classroom << quint8(course.preference);
+}
+
+bool readCourse(QDataStream &in, Course &course)
+{
+    quint8 preference = 0;
+    in >> course.name >> course.day >> course.startTime >> course.endTime
+       >> course.classroom >> preference;
+
+    if (preference > quint8(SectionPreference::Excluded)) return false;
+    course.preference = static_cast<SectionPreference>(preference);
+    return in.status() == QDataStream::Ok;
+}
+
+QByteArray frame(const QByteArray &payload)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+    out << quint32(payload.size()) << qChecksum(payload);
+    bytes.append(payload);
+    return bytes;
+}
+
+QByteArray journalHeader()
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+    out << JournalMagic << JournalVersion;
+    return bytes;
+}
+
+} // namespace
+
+CourseStore::CourseStore()
+    : CourseStore(QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation))
+                      .filePath("courses"))
+{
+}
+
+CourseStore::CourseStore(const QString &directory)
+    : directory(directory)
+    , recordCount(0)
+{
+}
+
+CourseStore::~CourseStore()
+{
+    close();
+}
+
+// Student IDs are typed by users, so they are hex-encoded into the file name
+QString CourseStore::journalPath(const QString &studentID) const
+{
+    return QDir(directory).filePath(QString::fromLatin1(studentID.toUtf8().toHex()) + ".journal");
+}
+
+bool CourseStore::open(const QString &studentID, QVector<Course> &courses)
+{
+    close();
+    courses.clear();
+    lastError.clear();
+
+    if (studentID.isEmpty()) {
+        lastError = "No student ID given";
+        return false;
+    }
+    if (!QDir().mkpath(directory)) {
+        lastError = QString("Cannot create %1").arg(directory);
+        return false;
+    }
+
+    currentStudent = studentID;
+    journal.setFileName(journalPath(studentID));
+
+    if (!replay(courses)) {
+        currentStudent.clear();
+        return false;
+    }
+
+    // a failed compaction leaves the old journal in place, which is fine
+    compactIfNeeded();
+
+    if (!openForAppend()) {
+        journal.close();
+        currentStudent.clear();
+        mirror.clear();
+        return false;
+    }
+    return true;
+}
+
+void CourseStore::close()
+{
+    journal.close();
+    currentStudent.clear();
+    mirror.clear();
+    recordCount = 0;
+}
+
+bool CourseStore::isOpen() const
+{
+    return !currentStudent.isEmpty() && journal.isOpen();
+}
+
+QString CourseStore::studentID() const
+{
+    return currentStudent;
+}
+
+QString CourseStore::errorString() const
+{
+    return lastError;
+}
+
+// Reads every complete record; a damaged or half-written tail is cut off
+// so later appends continue from the last good record
+bool CourseStore::replay(QVector<Course> &courses)
+{
+    recordCount = 0;
+    mirror.clear();
+
+    if (!journal.exists()) return true;  // new student, nothing saved yet
+
+    // shorter than a header: cut off while it was being created, so
+    // nothing was saved in it yet; emptied, it gets a fresh header
+    if (journal.size() < HeaderSize) {
+        if (journal.size() > 0 && !QFile::resize(journal.fileName(), 0)) {
+            lastError = QString("Cannot repair %1").arg(journal.fileName());
+            return false;
+        }
+        return true;
+    }
+
+    if (!journal.open(QIODevice::ReadOnly)) {
+        lastError = QString("Cannot read %1").arg(journal.fileName());
+        return false;
+    }
+
+    QDataStream in(&journal);
+    in.setVersion(StreamVersion);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != JournalMagic || version != JournalVersion) {
+        journal.close();
+        lastError = QString("%1 is not a course journal").arg(journal.fileName());
+        return false;
+    }
+
+    qint64 goodSize = HeaderSize;
+    while (!in.atEnd()) {
+        quint32 size = 0;
+        quint16 checksum = 0;
+        in >> size >> checksum;
+        if (in.status() != QDataStream::Ok || size > MaxPayloadSize) break;
+
+        QByteArray payload = journal.read(size);
+        if (payload.size() != qsizetype(size) || qChecksum(payload) != checksum) break;
+        if (!applyRecord(payload, courses)) break;
+
+        recordCount++;
+        goodSize += FrameHeaderSize + size;
+    }
+
+    const bool damagedTail = journal.size() > goodSize;
+    journal.close();
+
+    if (damagedTail && !QFile::resize(journal.fileName(), goodSize)) {
+        lastError = QString("Cannot repair %1").arg(journal.fileName());
+        return false;
+    }
+
+    mirror = courses;
+    return true;
+}
+
+bool CourseStore::applyRecord(const QByteArray &payload, QVector<Course> &courses) const
+{
+    QDataStream in(payload);
+    in.setVersion(StreamVersion);
+    quint8 operation = 0;
+    qint32 row = -1;
+    in >> operation >> row;
+
+    switch (static_cast<Operation>(operation)) {
+    case Operation::Add: {
+        Course course;
+        if (!readCourse(in, course)) return false;
+        courses.append(course);
+        return true;
+    }
+    case Operation::Update: {
+        Course course;
+        if (!readCourse(in, course) || row < 0 || row >= courses.size()) return false;
+        courses[row] = course;
+        return true;
+    }
+    case Operation::Remove:
+        if (row < 0 || row >= courses.size()) return false;
+        courses.removeAt(row);
+        return true;
+    }
+    return false;
+}
+
+bool CourseStore::openForAppend()
+{
+    const bool isNew = !journal.exists() || journal.size() == 0;
+
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        lastError = QString("Cannot write %1").arg(journal.fileName());
+        return false;
+    }
+    if (isNew && (journal.write(journalHeader()) != HeaderSize || !journal.flush())) {
+        lastError = QString("Cannot write %1").arg(journal.fileName());
+        return false;
+    }
+    return true;
+}
+
+bool CourseStore::recordAdd(const Course &course)
+{
+    return appendRecord(Operation::Add, -1, &course);
+}
+
+bool CourseStore::recordUpdate(int row, const Course &course)
+{
+    return appendRecord(Operation::Update, row, &course);
+}
+
+bool CourseStore::recordRemove(int row)
+{
+    return appendRecord(Operation::Remove, row, nullptr);
+}
+
+// One record per change, flushed straight away; the file is never rewritten here
+bool CourseStore::appendRecord(Operation operation, int row, const Course *course)
+{
+    if (currentStudent.isEmpty()) {
+        lastError = "No student is logged in";
+        return false;
+    }
+    // compaction could not reopen the journal: try again, and report the
+    // I/O error if it still fails
+    if (!journal.isOpen() && !openForAppend()) return false;
+    if (operation != Operation::Add && (row < 0 || row >= mirror.size())) {
+        lastError = "Invalid course change";
+        return false;
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+    out << quint8(operation) << qint32(row);
+    if (course) writeCourse(out, *course);
+
+    const qint64 sizeBefore = journal.size();
+    const QByteArray bytes = frame(payload);
+    if (journal.write(bytes) != bytes.size() || !journal.flush()) {
+        // drop any half-written bytes so later records are not lost behind them
+        journal.resize(sizeBefore);
+        lastError = QString("Cannot write %1").arg(journal.fileName());
+        return false;
+    }
+
+    applyRecord(payload, mirror);
+    recordCount++;
+
+    // the record is safely on disk; a failed compaction is retried next time
+    compactIfNeeded();
+    return true;
+}
+
+// Rewrites the journal as one Add per course; QSaveFile swaps the new
+// file in only once it is complete, so a crash leaves the old journal
+bool CourseStore::compactIfNeeded()
+{
+    if (recordCount < CompactMinRecords || recordCount <= CompactRatio * mirror.size()) {
+        return true;
+    }
+
+    // the old file can't be replaced while it is open on some systems
+    const bool wasOpen = journal.isOpen();
+    journal.close();
+
+    QSaveFile file(journal.fileName());
+    bool written = file.open(QIODevice::WriteOnly);
+    if (written) {
+        file.write(journalHeader());
+        for (const Course &course : mirror) {
+            QByteArray payload;
+            QDataStream out(&payload, QIODevice::WriteOnly);
+            out.setVersion(StreamVersion);
+            out << quint8(Operation::Add) << qint32(-1);
+            writeCourse(out, course);
+            file.write(frame(payload));
+        }
+        written = file.commit();
+    }
+
+    if (written) {
+        recordCount = mirror.size();
+    } else {
+        lastError = QString("Cannot compact %1").arg(journal.fileName());
+    }
+
+    if (wasOpen && !openForAppend()) return false;
+    return written;
+}
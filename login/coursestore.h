@@ -0,0 +1,94 @@
+/**
+ * CourseStore Header File
+ *
+ * This file defines the on-disk store that keeps each student's course
+ * list between sessions.
+ */
+
+#ifndef COURSESTORE_H
+#define COURSESTORE_H
+
+#include <QVector>
+#include <QString>
+#include <QFile>
+
+struct Course;  // Forward declaration
+
+/**
+ * CourseStore Class
+ *
+ * One append-only journal file per student ID. Every add, edit or delete
+ * is written as one small record before the change is applied in memory,
+ * so saving never rewrites the whole list. Opening a student replays the
+ * journal to rebuild the list.
+ *
+ * Each record carries its length and a checksum. A record cut short by a
+ * crash is detected on replay and cut off; everything before it is kept.
+ *
+ * When the journal has grown to well over the number of live courses it
+ * is compacted: rewritten as one record per course and swapped in
+ * atomically, so replay time stays proportional to the course list.
+ */
+class CourseStore {
+public:
+    /**
+     * Stores journals in the application data directory
+     */
+    CourseStore();
+
+    /**
+     * @param directory: Folder for the journal files (created if missing)
+     */
+    explicit CourseStore(const QString &directory);
+
+    ~CourseStore();
+
+    /**
+     * Opens (or creates) the journal of one student and replays it
+     * @param studentID: Student whose courses to load
+     * @param courses: Receives the saved course list
+     * @return false if the journal could not be read or opened for writing
+     */
+    bool open(const QString &studentID, QVector<Course> &courses);
+
+    /**
+     * Closes the current journal; nothing is lost, every record is already on disk
+     */
+    void close();
+
+    bool isOpen() const;
+    QString studentID() const;
+
+    /**
+     * Journal one change; call before applying it to the in-memory list
+     * @return false if the record could not be written (see errorString())
+     */
+    bool recordAdd(const Course &course);
+    bool recordUpdate(int row, const Course &course);
+    bool recordRemove(int row);
+
+    QString errorString() const;
+
+private:
+    enum class Operation : quint8 {
+        Add = 1,
+        Update = 2,
+        Remove = 3
+    };
+
+    QString journalPath(const QString &studentID) const;
+    bool replay(QVector<Course> &courses);
+    bool appendRecord(Operation operation, int row, const Course *course);
+    bool applyRecord(const QByteArray &payload, QVector<Course> &courses) const;
+    bool compactIfNeeded();
+    bool openForAppend();
+
+    QString directory;
+    QString currentStudent;
+    QFile journal;
+    QVector<Course> mirror;  // Course list as of the last record, used for compaction
+    int recordCount;         // Records in the journal file
+    QString lastError;
+};
+
+#endif // COURSESTORE_H
@@ -0,0 +1,233 @@
+/**
+ * ExamScheduler Implementation File
+ *
+ * Implements conflict-graph construction, DSatur and TabuCol.
+ */
+
+#include "examscheduler.h"
+#include <QHash>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <queue>
+#include <tuple>
+#include <climits>
+
+namespace {
+
+const int IterationsPerTimeCheck = 256;
+const int BaseTabuTenure = 10;
+
+} // namespace
+
+ExamScheduler::ExamScheduler()
+    : slotsPerDay(3)
+    , random(1)  // fixed seed so the same enrollments give the same answer
+{
+}
+
+void ExamScheduler::setSlotsPerDay(int count)
+{
+    slotsPerDay = qMax(1, count);
+}
+
+ExamResult ExamScheduler::schedule(const QVector<QStringList> &enrollments,
+                                   const QVector<QPair<QString, QString>> &extraConflicts,
+                                   int budgetMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    random.seed(1);
+
+    ExamResult result;
+    QHash<QString, int> courseIndex;
+    auto indexOf = [&](const QString &name) {
+        auto it = courseIndex.constFind(name);
+        if (it == courseIndex.constEnd()) {
+            it = courseIndex.insert(name, result.courses.size());
+            result.courses.append(name);
+        }
+        return it.value();
+    };
+
+    // Every edge once as (low << 32 | high), then sorted and deduplicated
+    QVector<QVector<int>> studentCourses;
+    QVector<quint64> edges;
+    studentCourses.reserve(enrollments.size());
+    for (const QStringList &names : enrollments) {
+        QVector<int> taken;
+        for (const QString &name : names) {
+            if (!name.isEmpty()) taken.append(indexOf(name));
+        }
+        std::sort(taken.begin(), taken.end());
+        taken.erase(std::unique(taken.begin(), taken.end()), taken.end());
+
+        for (int i = 0; i < taken.size(); ++i) {
+            for (int j = i + 1; j < taken.size(); ++j) {
+                edges.append((quint64(taken[i]) << 32) | quint32(taken[j]));
+            }
+        }
+        studentCourses.append(taken);
+    }
+    for (const auto &pair : extraConflicts) {
+        const int a = indexOf(pair.first);
+        const int b = indexOf(pair.second);
+        if (a != b) edges.append((quint64(qMin(a, b)) << 32) | quint32(qMax(a, b)));
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    adjacency = QVector<QVector<int>>(result.courses.size());
+    for (quint64 edge : edges) {
+        const int a = int(edge >> 32);
+        const int b = int(edge & 0xffffffffu);
+        adjacency[a].append(b);
+        adjacency[b].append(a);
+    }
+
+    if (result.courses.isEmpty()) return result;
+
+    // DSatur first, then remove slots one at a time while tabu search succeeds
+    result.slotCount = result.dsaturSlotCount = dsatur(result.slots);
+
+    while (result.slotCount > 1 && timer.elapsed() < budgetMs) {
+        const int target = result.slotCount - 1;
+        QVector<int> candidate = result.slots;
+        for (int &color : candidate) {
+            if (color == target) color = random.bounded(target);
+        }
+        if (!tabuColor(candidate, target, budgetMs - timer.elapsed())) break;
+
+        result.slots = candidate;
+        result.slotCount = target;
+    }
+
+    result.conflicts = countConflicts(result.slots);
+
+    // A student has back-to-back exams if two of them are adjacent on one day
+    for (const QVector<int> &taken : studentCourses) {
+        QVector<int> slots;
+        for (int course : taken) slots.append(result.slots[course]);
+        std::sort(slots.begin(), slots.end());
+
+        for (int i = 1; i < slots.size(); ++i) {
+            if (slots[i] == slots[i - 1] + 1 && slots[i] / slotsPerDay == slots[i - 1] / slotsPerDay) {
+                result.backToBackStudents++;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+// Colours the most constrained course next: highest saturation (distinct
+// neighbour colours), then highest degree. Stale queue entries are skipped.
+int ExamScheduler::dsatur(QVector<int> &colors) const
+{
+    const int n = adjacency.size();
+    colors.fill(-1, n);
+
+    QVector<QVector<bool>> neighbourColors(n);  // grows with the colours in use
+    QVector<int> saturation(n, 0);
+
+    using Entry = std::tuple<int, int, int>;  // saturation, degree, -course
+    std::priority_queue<Entry> queue;
+    for (int v = 0; v < n; ++v) queue.push({ 0, int(adjacency[v].size()), -v });
+
+    int colorCount = 0;
+    while (!queue.empty()) {
+        const auto [entrySaturation, degree, negated] = queue.top();
+        queue.pop();
+        const int v = -negated;
+        if (colors[v] >= 0 || entrySaturation != saturation[v]) continue;
+
+        // lowest colour no neighbour uses
+        int color = 0;
+        while (color < neighbourColors[v].size() && neighbourColors[v][color]) color++;
+        colors[v] = color;
+        colorCount = qMax(colorCount, color + 1);
+
+        for (int u : adjacency[v]) {
+            if (colors[u] >= 0) continue;
+            QVector<bool> &used = neighbourColors[u];
+            if (used.size() <= color) used.resize(color + 1, false);
+            if (used[color]) continue;
+
+            used[color] = true;
+            saturation[u]++;
+            queue.push({ saturation[u], int(adjacency[u].size()), -u });
+        }
+    }
+    return colorCount;
+}
+
+// TabuCol: move one conflicting course to another colour per iteration,
+// picking the move that removes the most conflicts. Recently left colours
+// are tabu for a while, unless the move solves the colouring outright.
+bool ExamScheduler::tabuColor(QVector<int> &colors, int colorCount, qint64 deadlineMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const int n = adjacency.size();
+
+    // gamma[v * colorCount + c] = neighbours of v that have colour c
+    QVector<int> gamma(qsizetype(n) * colorCount, 0);
+    for (int v = 0; v < n; ++v) {
+        for (int u : adjacency[v]) gamma[qsizetype(v) * colorCount + colors[u]]++;
+    }
+    QVector<qint64> tabuUntil(qsizetype(n) * colorCount, 0);
+
+    int conflicts = 0;
+    for (int v = 0; v < n; ++v) conflicts += gamma[qsizetype(v) * colorCount + colors[v]];
+    conflicts /= 2;
+
+    for (qint64 iteration = 1; conflicts > 0; ++iteration) {
+        if (iteration % IterationsPerTimeCheck == 0 && timer.elapsed() >= deadlineMs) return false;
+
+        int bestVertex = -1;
+        int bestColor = -1;
+        int bestDelta = INT_MAX;
+        for (int v = 0; v < n; ++v) {
+            const int *row = gamma.constData() + qsizetype(v) * colorCount;
+            const int current = row[colors[v]];
+            if (current == 0) continue;
+
+            for (int c = 0; c < colorCount; ++c) {
+                if (c == colors[v]) continue;
+                const int delta = row[c] - current;
+                const bool tabu = tabuUntil[qsizetype(v) * colorCount + c] > iteration;
+                if (tabu && conflicts + delta > 0) continue;
+                if (delta < bestDelta) {
+                    bestDelta = delta;
+                    bestVertex = v;
+                    bestColor = c;
+                }
+            }
+        }
+        if (bestVertex < 0) continue;  // everything tabu: wait for tenures to expire
+
+        const int oldColor = colors[bestVertex];
+        colors[bestVertex] = bestColor;
+        conflicts += bestDelta;
+        tabuUntil[qsizetype(bestVertex) * colorCount + oldColor] =
+            iteration + BaseTabuTenure + conflicts * 6 / 10 + random.bounded(BaseTabuTenure);
+
+        for (int u : adjacency[bestVertex]) {
+            gamma[qsizetype(u) * colorCount + oldColor]--;
+            gamma[qsizetype(u) * colorCount + bestColor]++;
+        }
+    }
+    return true;
+}
+
+int ExamScheduler::countConflicts(const QVector<int> &colors) const
+{
+    int conflicts = 0;
+    for (int v = 0; v < adjacency.size(); ++v) {
+        for (int u : adjacency[v]) {
+            if (u > v && colors[u] == colors[v]) conflicts++;
+        }
+    }
+    return conflicts;
+}
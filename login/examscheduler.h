@@ -0,0 +1,68 @@
+/**
+ * ExamScheduler Header File
+ *
+ * This file defines the exam-timetabling mode: every course gets one
+ * exam slot, and no student sits two exams in the same slot.
+ */
+
+#ifndef EXAMSCHEDULER_H
+#define EXAMSCHEDULER_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QPair>
+#include <QRandomGenerator>
+
+struct ExamResult {
+    QStringList courses;          // Every course, in first-seen order
+    QVector<int> slots;           // Exam slot of each course, 0 = first slot
+    int slotCount = 0;
+    int dsaturSlotCount = 0;      // Before tabu search tried to shrink it
+    int conflicts = 0;            // Courses sharing a student and a slot (0 normally)
+    int backToBackStudents = 0;   // Students with exams in consecutive slots of one day
+};
+
+/**
+ * ExamScheduler Class
+ *
+ * Exam scheduling as graph colouring: courses are vertices, an edge joins
+ * two courses that share a student (or that must not share a slot for
+ * another reason), and slots are colours.
+ *
+ * DSatur gives a good first colouring quickly: it always colours the
+ * course with the most differently-coloured neighbours next. Tabu search
+ * (TabuCol) then tries to remove one slot at a time, until a slot cannot
+ * be removed or the time budget runs out.
+ *
+ * Runs on the calling thread; a fixed seed makes the output repeatable.
+ */
+class ExamScheduler {
+public:
+    ExamScheduler();
+
+    /**
+     * Slots per exam day, used for the back-to-back count (default 3)
+     */
+    void setSlotsPerDay(int count);
+
+    /**
+     * @param enrollments: Course names taken by each student
+     * @param extraConflicts: Course pairs that must not share a slot
+     * @param budgetMs: Time for tabu search after DSatur
+     */
+    ExamResult schedule(const QVector<QStringList> &enrollments,
+                        const QVector<QPair<QString, QString>> &extraConflicts,
+                        int budgetMs);
+
+private:
+    int dsatur(QVector<int> &colors) const;
+    bool tabuColor(QVector<int> &colors, int colorCount, qint64 deadlineMs);
+    int countConflicts(const QVector<int> &colors) const;
+
+    QVector<QVector<int>> adjacency;  // Neighbour courses, sorted
+    int slotsPerDay;
+    QRandomGenerator random;
+};
+
+#endif // EXAMSCHEDULER_H
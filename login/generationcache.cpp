@@ -0,0 +1,161 @@
+/**
+ * GenerationCache Implementation File
+ *
+ * Implements hashing of course sets and the memory/disk result cache.
+ */
+
+#include "generationcache.h"
+#include "managecoursespage.h"
+#include "timetableengine.h"
+#include "tracer.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+
+namespace {
+
+const quint32 ResultMagic = 0x54475231;  // "TGR1"
+const quint16 ResultVersion = 1;
+const int StreamVersion = QDataStream::Qt_6_0;
+
+const int MemoryCacheKB = 32 * 1024;  // results kept in memory
+const int MaxResultFiles = 64;        // newest result files kept on disk
+
+// Serializes a result, compressing the memo (it is mostly small integers)
+QByteArray encodeResult(const QString &key, const GenerationResult &result)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+
+    out << ResultMagic << ResultVersion << key << result.validCount
+        << qCompress(result.engineMemo) << result.bestChoices << result.optimizerSettled;
+    return data;
+}
+
+bool decodeResult(const QByteArray &data, const QString &key, GenerationResult &result)
+{
+    QDataStream in(data);
+    in.setVersion(StreamVersion);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    QString storedKey;
+    QByteArray compressedMemo;
+    in >> magic >> version >> storedKey;
+    if (in.status() != QDataStream::Ok || magic != ResultMagic ||
+        version != ResultVersion || storedKey != key) {
+        return false;
+    }
+
+    in >> result.validCount >> compressedMemo >> result.bestChoices >> result.optimizerSettled;
+    if (in.status() != QDataStream::Ok) return false;
+
+    result.engineMemo = qUncompress(compressedMemo);
+    return true;
+}
+
+int costKB(const GenerationResult &result)
+{
+    return qMax<int>(1, int(result.engineMemo.size() / 1024));
+}
+
+// Oldest files beyond the limit are removed; storing a result rewrites
+// its file, so recently used results count as new
+void removeOldFiles(const QString &directory)
+{
+    QDir dir(directory);
+    const QStringList files = dir.entryList({ "*.result" }, QDir::Files, QDir::Time);
+    for (int i = MaxResultFiles; i < files.size(); ++i) {
+        dir.remove(files[i]);
+    }
+}
+
+} // namespace
+
+GenerationCache::GenerationCache()
+    : GenerationCache(QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation))
+                          .filePath("results"))
+{
+}
+
+GenerationCache::GenerationCache(const QString &directory)
+    : directory(directory)
+    , recent(MemoryCacheKB)
+{
+    // a single thread runs writes first in, first out; the pool's
+    // destructor waits for the last one
+    writer.setMaxThreadCount(1);
+}
+
+QString GenerationCache::keyFor(const QVector<Course> &courses, const ScheduleConstraints &constraints)
+{
+    // same order the engine sees after grouping by name
+    QVector<const Course *> sorted;
+    sorted.reserve(courses.size());
+    for (const Course &course : courses) sorted.append(&course);
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Course *a, const Course *b) {
+        return a->name < b->name;
+    });
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(StreamVersion);
+
+    out << ResultVersion << constraints.earliestStart << constraints.latestEnd << quint32(sorted.size());
+    for (const Course *course : sorted) {
+        out << course->name << course->day << course->startTime << course->endTime
+            << course->classroom << quint8(course->preference);
+    }
+
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex());
+}
+
+QString GenerationCache::filePath(const QString &key) const
+{
+    return QDir(directory).filePath(key + ".result");
+}
+
+bool GenerationCache::lookup(const QString &key, GenerationResult &result)
+{
+    if (GenerationResult *cached = recent.object(key)) {
+        result = *cached;
+        return true;
+    }
+
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    GenerationResult loaded;
+    if (!decodeResult(file.readAll(), key, loaded)) return false;
+
+    result = loaded;
+    recent.insert(key, new GenerationResult(loaded), qMin(costKB(loaded), MemoryCacheKB));
+    return true;
+}
+
+void GenerationCache::store(const QString &key, const GenerationResult &result)
+{
+    recent.insert(key, new GenerationResult(result), qMin(costKB(result), MemoryCacheKB));
+
+    // Encoding and writing can take a while for a big memo, so both
+    // happen on the writer thread; QSaveFile never leaves a partial file
+    const QString dir = directory;
+    const QString path = filePath(key);
+    QtConcurrent::run(&writer, [dir, path, key, result]() {
+        TRACE_SCOPE("worker", "store result");
+        if (!QDir().mkpath(dir)) return;
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) return;
+        file.write(encodeResult(key, result));
+        if (file.commit()) {
+            removeOldFiles(dir);
+        }
+    });
+}
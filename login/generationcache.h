@@ -0,0 +1,84 @@
+/**
+ * GenerationCache Header File
+ *
+ * This file defines the cache that keeps timetable generation results
+ * for a course set, so opening the same courses again is instant.
+ */
+
+#ifndef GENERATIONCACHE_H
+#define GENERATIONCACHE_H
+
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+#include <QCache>
+#include <QThreadPool>
+
+struct Course;  // Forward declaration
+struct ScheduleConstraints;
+
+/**
+ * Generation Result
+ *
+ * Everything worth keeping from one timetable generation.
+ */
+struct GenerationResult {
+    quint64 validCount = 0;         // Number of conflict-free timetables
+    QByteArray engineMemo;          // TimetableEngine::saveMemo(), empty if too big to keep
+    QVector<int> bestChoices;       // Optimizer's best answer, empty if none
+    bool optimizerSettled = false;  // Optimizer had finished searching
+};
+
+/**
+ * GenerationCache Class
+ *
+ * Content-addressed: results are stored under a hash of the normalized
+ * course set and constraints (keyFor()). Any change to a course gives a
+ * different key, so stale results are never found - nothing has to be
+ * invalidated by hand.
+ *
+ * Recent results are kept in memory (shared by the View and Generate
+ * buttons); every result is also written to disk in the background so
+ * later sessions can reuse it. Only the most recent files are kept.
+ * Writes run one at a time in the order they were stored, so a newer
+ * result for a key is never overwritten by an older one.
+ */
+class GenerationCache {
+public:
+    /**
+     * Stores results in the application data directory
+     */
+    GenerationCache();
+
+    /**
+     * @param directory: Folder for the result files (created if missing)
+     */
+    explicit GenerationCache(const QString &directory);
+
+    /**
+     * Hash of everything that affects generation
+     * Courses are sorted by name the same way TimetableEngine groups
+     * them, keeping the order of sections within a course (page order
+     * depends on it).
+     */
+    static QString keyFor(const QVector<Course> &courses, const ScheduleConstraints &constraints);
+
+    /**
+     * @return true and fills result if this key was stored before
+     */
+    bool lookup(const QString &key, GenerationResult &result);
+
+    /**
+     * Remembers a result; the disk copy is written on the writer thread
+     */
+    void store(const QString &key, const GenerationResult &result);
+
+private:
+    QString filePath(const QString &key) const;
+
+    QString directory;
+    QCache<QString, GenerationResult> recent;  // Cost in KB
+    QThreadPool writer;  // One thread: disk writes in store() order
+};
+
+#endif // GENERATIONCACHE_H
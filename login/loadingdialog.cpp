@@ -1,4 +1,5 @@
 #include "loadingdialog.h"
+#include "tracer.h"
 #include <QVBoxLayout>
 #include <QPalette>
 #include <QFont>
@@ -6,6 +7,7 @@
 LoadingDialog::LoadingDialog(QWidget *parent)
     : QDialog(parent)
     , currentProgress(0)
+    , traceStartNs(0)
 {
     // Set window properties
     setWindowTitle("Generating Timetable");
@@ -72,6 +74,7 @@ LoadingDialog::~LoadingDialog()
 void LoadingDialog::startLoading()
 {
     currentProgress = 0;
+    traceStartNs = Tracer::nowNs();
     progressBar->setValue(0);
     timer->start(30); // Update every 30ms for smooth animation
 }
@@ -88,6 +91,8 @@ void LoadingDialog::updateProgress()
 
         // Emit signal and close dialog after a short delay
         QTimer::singleShot(300, this, [this]() {
+            // spans the whole animation, across many event loop turns
+            Tracer::record("ui", "LoadingDialog", traceStartNs, Tracer::nowNs() - traceStartNs);
             emit loadingComplete();
             accept();
         });
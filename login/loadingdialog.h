@@ -27,6 +27,7 @@ private:
     QLabel *loadingLabel;
     QTimer *timer;
     int currentProgress;
+    qint64 traceStartNs;  // When startLoading() was called, for the trace
 };
 
 #endif // LOADINGDIALOG_H
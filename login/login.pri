@@ -0,0 +1,78 @@
+# Everything but main.cpp, shared by login.pro and the benchmarks
+# (which include this file to run the real windows headless)
+
+QT += core gui concurrent svg network
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++17
+
+INCLUDEPATH += $$PWD
+
+# Counting allocation hooks, reported per operation: qmake CONFIG+=alloc_stats
+# (turns metrics on as well, so the numbers show in the debug overlay)
+alloc_stats {
+    CONFIG += metrics
+    DEFINES += TIMETABLE_ALLOC_STATS
+}
+
+# Hot-path timers/counters and a debug overlay: qmake CONFIG+=metrics
+metrics: DEFINES += TIMETABLE_METRICS
+
+SOURCES += \
+    $$PWD/mainwindow.cpp \
+    $$PWD/managecoursespage.cpp \
+    $$PWD/signupwindow.cpp \
+    $$PWD/timetable.cpp \
+    $$PWD/timetableengine.cpp \
+    $$PWD/timetableoptimizer.cpp \
+    $$PWD/timetablerenderer.cpp \
+    $$PWD/timetableexporter.cpp \
+    $$PWD/timetablegridwidget.cpp \
+    $$PWD/timetablethumbnailmodel.cpp \
+    $$PWD/timetablecomparedialog.cpp \
+    $$PWD/coursestore.cpp \
+    $$PWD/generationcache.cpp \
+    $$PWD/userstore.cpp \
+    $$PWD/sessionmanager.cpp \
+    $$PWD/schedulingserver.cpp \
+    $$PWD/registrarscheduler.cpp \
+    $$PWD/clashanalyzer.cpp \
+    $$PWD/examscheduler.cpp \
+    $$PWD/perfmetrics.cpp \
+    $$PWD/tracer.cpp \
+    $$PWD/allocstats.cpp \
+    $$PWD/memospill.cpp \
+    $$PWD/loadingdialog.cpp
+
+HEADERS += \
+    $$PWD/mainwindow.h \
+    $$PWD/managecoursespage.h \
+    $$PWD/signupwindow.h \
+    $$PWD/timetable.h \
+    $$PWD/timetableengine.h \
+    $$PWD/timetableoptimizer.h \
+    $$PWD/timetablerenderer.h \
+    $$PWD/timetableexporter.h \
+    $$PWD/timetablegridwidget.h \
+    $$PWD/timetablethumbnailmodel.h \
+    $$PWD/timetablecomparedialog.h \
+    $$PWD/coursestore.h \
+    $$PWD/generationcache.h \
+    $$PWD/userstore.h \
+    $$PWD/sessionmanager.h \
+    $$PWD/schedulingserver.h \
+    $$PWD/registrarscheduler.h \
+    $$PWD/clashanalyzer.h \
+    $$PWD/examscheduler.h \
+    $$PWD/perfmetrics.h \
+    $$PWD/tracer.h \
+    $$PWD/allocstats.h \
+    $$PWD/memospill.h \
+    $$PWD/loadingdialog.h
+
+FORMS += \
+    $$PWD/mainwindow.ui \
+    $$PWD/managecoursespage.ui \
+    $$PWD/signupwindow.ui \
+    $$PWD/timetable.ui
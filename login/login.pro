@@ -1,8 +1,9 @@
-QT += core gui
+# Sources, forms and the metrics/alloc_stats options live in login.pri
+include(login.pri)
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-
-CONFIG += c++17
+# Benchmarks are separate console projects:
+# - benchmarks/loginbench.pro: login latency at 100k accounts
+# - benchmarks/allocbench.pro: allocations per operation (headless)
 
 # Windows-specific configuration for creating standalone .exe
 win32 {
@@ -17,22 +18,4 @@ TARGET = login
 TEMPLATE = app
 
 SOURCES += \
-    main.cpp \
-    mainwindow.cpp \
-    managecoursespage.cpp \
-    signupwindow.cpp \
-    timetable.cpp \
-    loadingdialog.cpp
-
-HEADERS += \
-    mainwindow.h \
-    managecoursespage.h \
-    signupwindow.h \
-    timetable.h \
-    loadingdialog.h
-
-FORMS += \
-    mainwindow.ui \
-    managecoursespage.ui \
-    signupwindow.ui \
-    timetable.ui
+    main.cpp
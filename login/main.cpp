@@ -1,7 +1,21 @@
 // Include Qt framework for creating GUI applications
 #include <QApplication>
+// Command line options (e.g. --auth-threads 4)
+#include <QCommandLineParser>
 // Include the main window class definition
 #include "mainwindow.h"
+// Local server mode (--server)
+#include "schedulingserver.h"
+// Chrome trace output (--trace)
+#include "tracer.h"
+// Allocation report on exit (CONFIG+=alloc_stats builds)
+#include "allocstats.h"
+// Memory budget for counting (--memory-budget)
+#include "timetableengine.h"
+#include <QTextStream>
+#include <QScopedPointer>
+#include <cstring>
+#include <limits>
 
 /**
  * Main entry point of the Course Timetable Management System
@@ -11,17 +25,120 @@
  */
 int main(int argc, char *argv[])
 {
+    // The server shows no window, so it runs without the GUI (and needs no
+    // display); look for --server before the application object exists
+    bool serverMode = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--server") == 0 || std::strncmp(argv[i], "--server=", 9) == 0) {
+            serverMode = true;
+        }
+    }
+
     // Create the Qt application object - manages application-wide resources
     // argc and argv are command-line arguments passed to the program
-    QApplication app(argc, argv);
+    QScopedPointer<QCoreApplication> app(serverMode ? new QCoreApplication(argc, argv)
+                                                    : new QApplication(argc, argv));
+
+    /**
+     * Command Line Options
+     *
+     * --auth-threads <count>: how many password checks may run at once
+     * (login and registration hash passwords on background threads)
+     * --server <name>: run as a local scheduling server instead of
+     * showing any window (see SchedulingServer for the JSON protocol)
+     * --server-threads <count>: requests the server handles at once
+     * --trace <file>: record a Chrome trace of this session into file
+     * (the TIMETABLE_TRACE environment variable does the same)
+     * --memory-budget <MB>: memory for counting before it spills to disk
+     */
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Course Timetable Management System");
+    parser.addHelpOption();
+
+    QCommandLineOption authThreadsOption("auth-threads",
+                                         "Maximum number of password checks running at once.",
+                                         "count");
+    parser.addOption(authThreadsOption);
+
+    QCommandLineOption serverOption("server",
+                                    "Run as a local scheduling server on this socket name.",
+                                    "name");
+    parser.addOption(serverOption);
+
+    QCommandLineOption serverThreadsOption("server-threads",
+                                           "Maximum number of server requests handled at once.",
+                                           "count");
+    parser.addOption(serverThreadsOption);
+
+    QCommandLineOption traceOption("trace",
+                                   "Write a Chrome trace (chrome://tracing, Perfetto) of this session to file.",
+                                   "file");
+    parser.addOption(traceOption);
+
+    QCommandLineOption memoryBudgetOption("memory-budget",
+                                          "Memory (MB) the timetable counter may use before spilling to a temporary file.",
+                                          "MB");
+    parser.addOption(memoryBudgetOption);
+    parser.process(*app);
+
+    if (parser.isSet(memoryBudgetOption)) {
+        // a whole number of MB that still fits in bytes
+        bool ok = false;
+        const qint64 megabytes = parser.value(memoryBudgetOption).toLongLong(&ok);
+        if (!ok || megabytes <= 0 || megabytes > std::numeric_limits<qint64>::max() / (1024 * 1024)) {
+            QTextStream(stderr) << "--memory-budget needs a positive number of MB, not \""
+                                << parser.value(memoryBudgetOption) << '"' << Qt::endl;
+            return 1;
+        }
+        TimetableEngine::setDefaultMemoryBudget(megabytes * 1024 * 1024);
+    }
+
+    // Tracing is opt-in; the file is written when the event loop ends
+    const QString traceFile = parser.isSet(traceOption)
+                                  ? parser.value(traceOption)
+                                  : qEnvironmentVariable("TIMETABLE_TRACE");
+    Tracer::start(traceFile);
+    auto finishTrace = [&traceFile](int exitCode) {
+        if (!Tracer::stop()) {
+            QTextStream(stderr) << "Cannot write trace file " << traceFile << Qt::endl;
+        }
+#ifdef TIMETABLE_ALLOC_STATS
+        QTextStream(stderr) << AllocStats::summary() << Qt::endl;
+#endif
+        return exitCode;
+    };
+
+    /**
+     * Server Mode
+     * Other programs on this machine send JSON requests; no window is shown
+     */
+    if (parser.isSet(serverOption)) {
+        SchedulingServer server;
+        if (parser.isSet(serverThreadsOption)) {
+            server.setMaxThreads(parser.value(serverThreadsOption).toInt());
+        }
+
+        QTextStream err(stderr);
+        const QString name = parser.value(serverOption);
+        if (!server.listen(name)) {
+            err << "Cannot listen on " << name << ": " << server.errorString() << Qt::endl;
+            return 1;
+        }
+        err << "Scheduling server listening on " << name << Qt::endl;
+        return finishTrace(app->exec());
+    }
 
     // Create the main login window instance
     MainWindow window;
 
+    if (parser.isSet(authThreadsOption)) {
+        window.setAuthConcurrency(parser.value(authThreadsOption).toInt());
+    }
+
     // Display the window on screen - makes it visible to the user
     window.show();
 
     // Start the event loop - keeps the application running until user closes it
     // This function blocks until the application exits
-    return app.exec();
+    return finishTrace(app->exec());
 }
@@ -9,7 +9,21 @@
 #include "ui_mainwindow.h"
 #include "signupwindow.h"
 #include "managecoursespage.h"
+#include "tracer.h"
 #include <QMessageBox>
+#include <QFutureWatcher>
+#include <QProgressBar>
+#include <QStatusBar>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+
+// Password checks that may run at once (each keeps one core busy),
+// and how many may wait before new attempts are turned away
+const int DefaultAuthConcurrency = 2;
+const int MaxPendingAuthTasks = 8;
+
+} // namespace
 
 /**
  * MainWindow Constructor
@@ -28,17 +42,35 @@ MainWindow::MainWindow(QWidget *parent)
     , ui(new Ui::MainWindow)
     , signupWindow(nullptr)
     , manageCoursesPage(nullptr)
+    , pendingAuthTasks(0)
+    , busyIndicator(nullptr)
 {
     // Set up the user interface defined in Qt Designer (.ui file)
     ui->setupUi(this);
 
+    // Busy indicator in the status bar, shown while a password is checked
+    busyIndicator = new QProgressBar(this);
+    busyIndicator->setRange(0, 0);  // no known end: animated "busy" bar
+    busyIndicator->setTextVisible(false);
+    busyIndicator->setMaximumWidth(160);
+    busyIndicator->hide();
+    ui->statusbar->addPermanentWidget(busyIndicator);
+
+    authPool.setMaxThreadCount(DefaultAuthConcurrency);
+
     // Set the window title that appears in the title bar
     this->setWindowTitle("Login");
 
-    // Initialize the user database with a default test account
-    // This allows immediate testing without registration
-    // Key: Student ID, Value: Password
-    registeredUsers["12345"] = "password123";
+    // Load the saved accounts (plus the default test account 12345,
+    // which allows immediate testing without registration)
+    if (!userStore.open()) {
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle("Error");
+        msgBox.setText("Failed to load registered accounts!\n\n" + userStore.errorString());
+        msgBox.setIcon(QMessageBox::Warning);
+        msgBox.setStyleSheet("QLabel{font-size: 11px;} QPushButton{font-size: 11px;}");
+        msgBox.exec();
+    }
 
     /**
      * Connect button signals to slots (Signal-Slot Mechanism)
@@ -65,6 +97,9 @@ MainWindow::MainWindow(QWidget *parent)
  */
 MainWindow::~MainWindow()
 {
+    // Let running password checks finish before the window goes away
+    authPool.waitForDone();
+
     // Delete the UI components
     delete ui;
 
@@ -114,9 +149,25 @@ void MainWindow::on_submit_clicked()
 
     /**
      * Authentication Process
-     * Uses validateLogin() to check if credentials match a registered user
+     * validateLogin() checks the password on a worker thread and then
+     * calls finishLogin() with the result
      */
-    if (validateLogin(studentID, password)) {
+    validateLogin(studentID, password);
+}
+
+/**
+ * Finish Login
+ *
+ * Called on the GUI thread once the password has been checked.
+ *
+ * @param studentID: The student ID that was checked
+ * @param valid: true if the password matched
+ */
+void MainWindow::finishLogin(const QString &studentID, bool valid)
+{
+    setLoginBusy(false);
+
+    if (valid) {
         // Login successful - show welcome message
         QMessageBox msgBox(this);
         msgBox.setWindowTitle("Login Successful");
@@ -126,7 +177,7 @@ void MainWindow::on_submit_clicked()
         msgBox.exec();
 
         // Navigate to the course management page
-        switchToManageCoursesPage();
+        switchToManageCoursesPage(studentID);
     } else {
         // Login failed - show error message
         QMessageBox msgBox(this);
@@ -182,16 +233,32 @@ void MainWindow::on_toggle_mode_clicked()
  *
  * @param studentID: The student ID to check
  * @param password: The password to verify
- * @return true if credentials are valid, false otherwise
  *
  * How it works:
- * 1. Check if studentID exists in the QMap (contains())
- * 2. If exists, check if the stored password matches the provided password
- * 3. Both conditions must be true for successful login
+ * 1. Look up the student's stored credential (hash index, instant)
+ * 2. Hash the password with the stored salt on a worker thread - this is
+ *    slow on purpose, so it must not run on the GUI thread
+ * 3. finishLogin() is called with the result
  */
-bool MainWindow::validateLogin(const QString &studentID, const QString &password)
+void MainWindow::validateLogin(const QString &studentID, const QString &password)
 {
-    return registeredUsers.contains(studentID) && registeredUsers[studentID] == password;
+    if (!reserveAuthSlot()) return;
+
+    // An unknown ID gets an invalid credential, which takes as long to reject
+    const Credential credential = userStore.credential(studentID);
+
+    setLoginBusy(true);  // one login attempt at a time from this window
+
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, studentID]() {
+        watcher->deleteLater();
+        pendingAuthTasks--;
+        finishLogin(studentID, watcher->result());
+    });
+    watcher->setFuture(QtConcurrent::run(&authPool, [credential, password]() {
+        TRACE_SCOPE("worker", "verify password");
+        return UserStore::verify(credential, password);
+    }));
 }
 
 /**
@@ -205,8 +272,8 @@ bool MainWindow::validateLogin(const QString &studentID, const QString &password
  *
  * Process:
  * 1. Check if student ID already exists (prevent duplicates)
- * 2. If new, add to registeredUsers map
- * 3. Show appropriate feedback message
+ * 2. If new, hash the password on a worker thread
+ * 3. finishRegistration() saves the account and shows feedback
  */
 void MainWindow::on_userRegistered(const QString &studentID, const QString &password)
 {
@@ -214,21 +281,65 @@ void MainWindow::on_userRegistered(const QString &studentID, const QString &pass
      * Duplicate Check
      * Prevent the same student ID from being registered twice
      */
-    if (registeredUsers.contains(studentID)) {
+    if (userStore.contains(studentID)) {
         QMessageBox msgBox(this);
         msgBox.setWindowTitle("Registration Failed");
         msgBox.setText("Student ID already exists!");
         msgBox.setIcon(QMessageBox::Critical);
         msgBox.setStyleSheet("QLabel{font-size: 11px;} QPushButton{font-size: 11px;}");
         msgBox.exec();
+        signupWindow->registrationFinished(false);
+        return;
+    }
+
+    if (!reserveAuthSlot()) {
+        signupWindow->registrationFinished(false);
         return;
     }
 
     /**
-     * Add New User to Database
-     * QMap automatically creates a new entry with the given key-value pair
+     * Hash the New Password
+     * Done on the auth thread pool; finishRegistration() saves the account.
+     * SignupWindow shows its busy bar until then.
      */
-    registeredUsers[studentID] = password;
+    QFutureWatcher<Credential> *watcher = new QFutureWatcher<Credential>(this);
+    connect(watcher, &QFutureWatcher<Credential>::finished, this, [this, watcher, studentID]() {
+        watcher->deleteLater();
+        pendingAuthTasks--;
+        finishRegistration(studentID, watcher->result());
+    });
+    watcher->setFuture(QtConcurrent::run(&authPool, [password]() {
+        TRACE_SCOPE("worker", "hash password");
+        return UserStore::makeCredential(password);
+    }));
+}
+
+/**
+ * Finish Registration
+ *
+ * Called on the GUI thread once the new password has been hashed.
+ * Saves the account (one line appended to the account file).
+ *
+ * @param studentID: New user's student ID
+ * @param credential: Salted hash of the new password
+ */
+void MainWindow::finishRegistration(const QString &studentID, const Credential &credential)
+{
+    // addUser() checks for duplicates again - the ID may have been
+    // registered while the password was being hashed
+    if (!userStore.addUser(studentID, credential)) {
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle("Registration Failed");
+        msgBox.setText(userStore.errorString());
+        msgBox.setIcon(QMessageBox::Critical);
+        msgBox.setStyleSheet("QLabel{font-size: 11px;} QPushButton{font-size: 11px;}");
+        msgBox.exec();
+        signupWindow->registrationFinished(false);
+        return;
+    }
+
+    // Close the signup window before the success message
+    signupWindow->registrationFinished(true);
 
     // Show success message
     QMessageBox msgBox(this);
@@ -246,14 +357,32 @@ void MainWindow::on_userRegistered(const QString &studentID, const QString &pass
  * displays the course management interface.
  *
  * Uses lazy initialization like the signup window.
+ *
+ * @param studentID: Logged-in student, whose saved courses are loaded
  */
-void MainWindow::switchToManageCoursesPage()
+void MainWindow::switchToManageCoursesPage(const QString &studentID)
 {
     // Create course page only if it doesn't exist yet
     if (manageCoursesPage == nullptr) {
         manageCoursesPage = new ManageCoursesPage(this);
     }
 
+    // Start (or resume) this student's session with their saved courses
+    QString errorMessage;
+    QSharedPointer<StudentSession> session = sessionManager.open(studentID, errorMessage);
+    if (!errorMessage.isEmpty()) {
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle("Error");
+        msgBox.setText("Failed to load your saved courses!\n\n" + errorMessage +
+                       "\n\nChanges made now will not be saved.");
+        msgBox.setIcon(QMessageBox::Warning);
+        msgBox.setStyleSheet("QLabel{font-size: 11px;} QPushButton{font-size: 11px;}");
+        msgBox.exec();
+    }
+
+    loggedInStudent = studentID;
+    manageCoursesPage->setSession(session);
+
     // Hide login window and show course page
     this->hide();
     manageCoursesPage->show();
@@ -268,10 +397,16 @@ void MainWindow::switchToManageCoursesPage()
 void MainWindow::switchToLoginPage()
 {
     // Hide course management page if it exists
+    // (its courses are already saved; the next student starts empty)
     if (manageCoursesPage) {
         manageCoursesPage->hide();
+        manageCoursesPage->clearSession();
     }
 
+    // The session may now be evicted to make room for other students
+    sessionManager.release(loggedInStudent);
+    loggedInStudent.clear();
+
     // Clear input fields for security (prevent password from remaining visible)
     ui->lineEdit_StudentID->clear();
     ui->lineEdit_Password->clear();
@@ -279,3 +414,61 @@ void MainWindow::switchToLoginPage()
     // Show the login window again
     this->show();
 }
+
+/**
+ * Set Auth Concurrency
+ *
+ * Limits how many password checks (login or registration) run at once.
+ * Hashing is CPU-bound, so more than the number of cores never helps.
+ *
+ * @param limit: Maximum number of parallel checks (at least 1)
+ */
+void MainWindow::setAuthConcurrency(int limit)
+{
+    authPool.setMaxThreadCount(qMax(1, limit));
+}
+
+/**
+ * Reserve Auth Slot
+ *
+ * Counts a new password check against the queue limit.
+ *
+ * @return true if the check may start; false (after telling the user)
+ *         if too many checks are already waiting
+ */
+bool MainWindow::reserveAuthSlot()
+{
+    if (pendingAuthTasks >= MaxPendingAuthTasks) {
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle("Busy");
+        msgBox.setText("Too many requests at the moment, please try again shortly.");
+        msgBox.setIcon(QMessageBox::Warning);
+        msgBox.setStyleSheet("QLabel{font-size: 11px;} QPushButton{font-size: 11px;}");
+        msgBox.exec();
+        return false;
+    }
+
+    pendingAuthTasks++;
+    return true;
+}
+
+/**
+ * Set Login Busy
+ *
+ * Locks the login form and shows the busy indicator while the password
+ * is being checked. The window itself stays responsive.
+ */
+void MainWindow::setLoginBusy(bool busy)
+{
+    ui->lineEdit_StudentID->setEnabled(!busy);
+    ui->lineEdit_Password->setEnabled(!busy);
+    ui->pushButton_Login->setEnabled(!busy);
+    ui->pushButton_SignUp->setEnabled(!busy);
+    busyIndicator->setVisible(busy);
+
+    if (busy) {
+        ui->statusbar->showMessage("Checking password...");
+    } else {
+        ui->statusbar->clearMessage();
+    }
+}
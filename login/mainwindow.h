@@ -2,7 +2,9 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QMap>
+#include <QThreadPool>
+#include "userstore.h"
+#include "sessionmanager.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -12,6 +14,7 @@ QT_END_NAMESPACE
 
 class SignupWindow;
 class ManageCoursesPage;
+class QProgressBar;
 
 class MainWindow : public QMainWindow
 {
@@ -22,19 +25,35 @@ public:
     ~MainWindow();
     void switchToLoginPage();
 
+    // Maximum number of password checks running at the same time
+    void setAuthConcurrency(int limit);
+
 private slots:
     void on_submit_clicked();
     void on_toggle_mode_clicked();
     void on_userRegistered(const QString &studentID, const QString &password);
 
 private:
-    bool validateLogin(const QString &studentID, const QString &password);
-    void switchToManageCoursesPage();
+    void validateLogin(const QString &studentID, const QString &password);
+    void finishLogin(const QString &studentID, bool valid);
+    void finishRegistration(const QString &studentID, const Credential &credential);
+    void switchToManageCoursesPage(const QString &studentID);
+    bool reserveAuthSlot();
+    void setLoginBusy(bool busy);
 
     Ui::MainWindow *ui;
     SignupWindow *signupWindow;
     ManageCoursesPage *manageCoursesPage;
-    QMap<QString, QString> registeredUsers;
+    UserStore userStore;  // Registered accounts, saved to disk
+
+    // Per-student course data; one window serves many students in turn
+    SessionManager sessionManager;
+    QString loggedInStudent;
+
+    // Password hashing runs here, never on the GUI thread
+    QThreadPool authPool;
+    int pendingAuthTasks;  // Checks queued or running in authPool
+    QProgressBar *busyIndicator;
 };
 
 #endif // MAINWINDOW_H
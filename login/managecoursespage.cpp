@@ -11,6 +11,10 @@
 #include "mainwindow.h"
 #include "timetable.h"
 #include "loadingdialog.h"
+#include "timetableengine.h"
+#include "sessionmanager.h"
+#include "tracer.h"
+#include "allocstats.h"
 #include <QMessageBox>
 #include <QPushButton>
 #include <QCheckBox>
@@ -23,6 +27,7 @@
 #include <QComboBox>
 #include <QTableWidget>
 #include <QTimer>
+#include <QSignalBlocker>
 
 /**
  * ManageCoursesPage Constructor
@@ -42,6 +47,7 @@
 ManageCoursesPage::ManageCoursesPage(QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::ManageCoursesPage)
+    , session(QSharedPointer<StudentSession>::create())
     , editingRow(-1)
     , timetableWindow(nullptr)
     , loadingDialog(nullptr) {
@@ -110,6 +116,28 @@ ManageCoursesPage::ManageCoursesPage(QWidget *parent)
         ui->endTimeInput->addItems(hours);
     }
 
+    /**
+     * Setup Time Window ComboBoxes
+     *
+     * Optional limits applied to every section before the timetable is
+     * generated, e.g. "never before 10am". "No limit" keeps all sections.
+     */
+    if (ui->earliestStartCombo && ui->latestEndCombo) {
+        QStringList hours;
+        for (int i = 8; i <= 11; ++i) {
+            hours << QString("%1am").arg(i);
+        }
+        hours << "12pm";
+        for (int i = 1; i <= 10; ++i) {
+            hours << QString("%1pm").arg(i);
+        }
+
+        ui->earliestStartCombo->addItem("No limit");
+        ui->earliestStartCombo->addItems(hours);
+        ui->latestEndCombo->addItem("No limit");
+        ui->latestEndCombo->addItems(hours);
+    }
+
     /**
      * Setup Course Table
      *
@@ -117,8 +145,8 @@ ManageCoursesPage::ManageCoursesPage(QWidget *parent)
      * This is a complex setup with multiple styling properties.
      */
     if (ui->coursetable) {
-        // Set table structure: 6 columns
-        ui->coursetable->setColumnCount(6);
+        // Set table structure: 7 columns
+        ui->coursetable->setColumnCount(7);
 
         // Set column headers
         ui->coursetable->setHorizontalHeaderLabels({
@@ -127,7 +155,8 @@ ManageCoursesPage::ManageCoursesPage(QWidget *parent)
             "Day",         // Column 2: Day of week
             "Time",        // Column 3: Start-End time
             "Classroom",   // Column 4: Classroom location
-            "Actions"      // Column 5: Edit and Delete buttons
+            "Preference",  // Column 5: Any / Lock / Exclude this section
+            "Actions"      // Column 6: Edit and Delete buttons
         });
 
         // Start with 0 rows (empty table)
@@ -140,7 +169,8 @@ ManageCoursesPage::ManageCoursesPage(QWidget *parent)
         ui->coursetable->setColumnWidth(2, 120);  // Day
         ui->coursetable->setColumnWidth(3, 120);  // Time
         ui->coursetable->setColumnWidth(4, 120);  // Classroom
-        ui->coursetable->setColumnWidth(5, 180);  // Actions (Edit + Delete buttons)
+        ui->coursetable->setColumnWidth(5, 120);  // Preference
+        ui->coursetable->setColumnWidth(6, 180);  // Actions (Edit + Delete buttons)
 
         /**
          * Scrolling Configuration
@@ -377,16 +407,16 @@ void ManageCoursesPage::onAddCourse() {
     // note: we allow same course name with different times/rooms
     // (useful for courses with multiple sections)
     // but prevent EXACT duplicates (same everything)
-    for (int i = 0; i < courses.size(); ++i) {
+    for (int i = 0; i < session->courses.size(); ++i) {
         // when editing, don't compare with the course we're currently editing
         if (i == editingRow) continue;
 
         // check if everything matches
-        if (courses[i].name == name &&
-            courses[i].day == day &&
-            courses[i].startTime == startTime &&
-            courses[i].endTime == endTime &&
-            courses[i].classroom == classroom) {
+        if (session->courses[i].name == name &&
+            session->courses[i].day == day &&
+            session->courses[i].startTime == startTime &&
+            session->courses[i].endTime == endTime &&
+            session->courses[i].classroom == classroom) {
 
             // show error message with details
             QMessageBox msgBox(this);
@@ -414,13 +444,21 @@ void ManageCoursesPage::onAddCourse() {
      * If editingRow is valid (>= 0), we're updating an existing course
      * instead of adding a new one.
      */
-    if (editingRow >= 0 && editingRow < courses.size()) {
+    if (editingRow >= 0 && editingRow < session->courses.size()) {
         // Update all fields of the existing course
-        courses[editingRow].name = name;
-        courses[editingRow].day = day;
-        courses[editingRow].startTime = startTime;
-        courses[editingRow].endTime = endTime;
-        courses[editingRow].classroom = classroom;
+        Course updated = session->courses[editingRow];
+        updated.name = name;
+        updated.day = day;
+        updated.startTime = startTime;
+        updated.endTime = endTime;
+        updated.classroom = classroom;
+
+        // Save to disk first; the change is only made if it was saved
+        if (!session->store.recordUpdate(editingRow, updated)) {
+            showStoreError();
+            return;
+        }
+        session->courses[editingRow] = updated;
 
         // Exit edit mode by resetting editingRow to -1
         editingRow = -1;
@@ -444,21 +482,32 @@ void ManageCoursesPage::onAddCourse() {
          *
          * Create a new Course struct and add it to the courses vector
          */
-        Course course;  // Create new Course struct
-        course.name = name;
-        course.day = day;
-        course.startTime = startTime;
-        course.endTime = endTime;
-        course.classroom = classroom;
+        // allocations up to the success message count as "add course"
+        {
+            ALLOC_SCOPE(AllocOperation::AddCourse);
+
+            Course course;  // Create new Course struct
+            course.name = name;
+            course.day = day;
+            course.startTime = startTime;
+            course.endTime = endTime;
+            course.classroom = classroom;
+
+            // Save to disk first; the course is only added if it was saved
+            if (!session->store.recordAdd(course)) {
+                showStoreError();
+                return;
+            }
 
-        // Add the course to our vector (dynamic array)
-        courses.append(course);
+            // Add the course to our vector (dynamic array)
+            session->courses.append(course);
 
-        // Update the table to show the new course
-        refreshTable();
+            // Update the table to show the new course
+            refreshTable();
 
-        // Clear the form for next course
-        clearForm();
+            // Clear the form for next course
+            clearForm();
+        }
 
         // Show success message
         QMessageBox msgBox(this);
@@ -482,12 +531,18 @@ void ManageCoursesPage::onAddCourse() {
  */
 void ManageCoursesPage::onDeleteCourse(int row) {
     // Validate row index
-    if (row >= 0 && row < courses.size()) {
+    if (row >= 0 && row < session->courses.size()) {
         // Save course name for confirmation message
-        QString name = courses[row].name;
+        QString name = session->courses[row].name;
+
+        // Save to disk first; the course is only removed if it was saved
+        if (!session->store.recordRemove(row)) {
+            showStoreError();
+            return;
+        }
 
         // Remove the course from the vector
-        courses.removeAt(row);
+        session->courses.removeAt(row);
 
         /**
          * Edit Mode State Management
@@ -520,6 +575,13 @@ void ManageCoursesPage::onDeleteCourse(int row) {
     }
 }
 
+// A top-level UpdateRequest repaints every dirty child of the window
+// (table, cell widgets, form), so timing it gives the cost of one frame
+bool ManageCoursesPage::event(QEvent *event) {
+    TRACE_SCOPE_IF(event->type() == QEvent::UpdateRequest, "paint", "ManageCoursesPage repaint");
+    return QDialog::event(event);
+}
+
 /**
  * Refresh Table Display (Complex Function)
  *
@@ -539,12 +601,14 @@ void ManageCoursesPage::onDeleteCourse(int row) {
 void ManageCoursesPage::refreshTable() {
     // Safety check
     if (!ui->coursetable) return;
+    TRACE_SCOPE("ui", "refreshTable");
+    ALLOC_SCOPE(AllocOperation::RefreshTable);
 
     // Set number of rows to match number of courses
-    ui->coursetable->setRowCount(courses.size());
+    ui->coursetable->setRowCount(session->courses.size());
 
     // Set row height to accommodate buttons (compact design)
-    for (int row = 0; row < courses.size(); ++row) {
+    for (int row = 0; row < session->courses.size(); ++row) {
         ui->coursetable->setRowHeight(row, 40);
     }
 
@@ -552,7 +616,7 @@ void ManageCoursesPage::refreshTable() {
      * Main Loop: Process Each Course
      * Iterates through all courses and creates a table row for each
      */
-    for (int row = 0; row < courses.size(); ++row) {
+    for (int row = 0; row < session->courses.size(); ++row) {
 
         /**
          * COLUMN 0: Checkbox Widget (Complex Widget Creation)
@@ -619,7 +683,7 @@ void ManageCoursesPage::refreshTable() {
          */
 
         // Column 1: Course Name
-        QTableWidgetItem *nameItem = new QTableWidgetItem(courses[row].name);
+        QTableWidgetItem *nameItem = new QTableWidgetItem(session->courses[row].name);
         // Remove editable flag (prevents user from clicking to edit)
         // Bitwise operation: removes ItemIsEditable flag from existing flags
         nameItem->setFlags(nameItem->flags() & ~Qt::ItemIsEditable);
@@ -627,27 +691,68 @@ void ManageCoursesPage::refreshTable() {
         ui->coursetable->setItem(row, 1, nameItem);
 
         // Column 2: Day
-        QTableWidgetItem *dayItem = new QTableWidgetItem(courses[row].day);
+        QTableWidgetItem *dayItem = new QTableWidgetItem(session->courses[row].day);
         dayItem->setFlags(dayItem->flags() & ~Qt::ItemIsEditable);
         dayItem->setForeground(QBrush(Qt::black));
         ui->coursetable->setItem(row, 2, dayItem);
 
         // Column 3: Time (formatted as "Start - End")
         QString timeStr = QString("%1 - %2")
-                              .arg(courses[row].startTime, courses[row].endTime);
+                              .arg(session->courses[row].startTime, session->courses[row].endTime);
         QTableWidgetItem *timeItem = new QTableWidgetItem(timeStr);
         timeItem->setFlags(timeItem->flags() & ~Qt::ItemIsEditable);
         timeItem->setForeground(QBrush(Qt::black));
         ui->coursetable->setItem(row, 3, timeItem);
 
         // Column 4: Classroom
-        QTableWidgetItem *classroomItem = new QTableWidgetItem(courses[row].classroom);
+        QTableWidgetItem *classroomItem = new QTableWidgetItem(session->courses[row].classroom);
         classroomItem->setFlags(classroomItem->flags() & ~Qt::ItemIsEditable);
         classroomItem->setForeground(QBrush(Qt::black));
         ui->coursetable->setItem(row, 4, classroomItem);
 
         /**
-         * COLUMN 5: Action Buttons (Complex Widget Creation)
+         * COLUMN 5: Section Preference
+         *
+         * Lock = this section must be in the timetable
+         * Exclude = this section must never be in the timetable
+         * The choice is stored on the course and applied when generating.
+         */
+        QComboBox *preferenceCombo = new QComboBox();
+        preferenceCombo->addItems({"Any", "Lock", "Exclude"});
+        preferenceCombo->setCurrentIndex(static_cast<int>(session->courses[row].preference));
+        preferenceCombo->setStyleSheet(
+            "QComboBox {"
+            "background-color: white;"
+            "color: black;"
+            "border: 1px solid #d0d0d0;"
+            "border-radius: 4px;"
+            "padding: 2px 6px;"
+            "font-size: 11px;"
+            "}"
+            "QComboBox QAbstractItemView {"
+            "background-color: white;"
+            "color: black;"
+            "selection-background-color: #3498db;"
+            "}"
+            );
+        connect(preferenceCombo, &QComboBox::currentIndexChanged, this, [this, row, preferenceCombo](int index) {
+            if (row < session->courses.size()) {
+                Course updated = session->courses[row];
+                updated.preference = static_cast<SectionPreference>(index);
+                if (session->store.recordUpdate(row, updated)) {
+                    session->courses[row] = updated;
+                } else {
+                    // put the combo back to the saved value
+                    QSignalBlocker blocker(preferenceCombo);
+                    preferenceCombo->setCurrentIndex(static_cast<int>(session->courses[row].preference));
+                    showStoreError();
+                }
+            }
+        });
+        ui->coursetable->setCellWidget(row, 5, preferenceCombo);
+
+        /**
+         * COLUMN 6: Action Buttons (Complex Widget Creation)
          *
          * Creates Edit and Delete buttons for each row.
          * This demonstrates:
@@ -760,7 +865,7 @@ void ManageCoursesPage::refreshTable() {
             QMessageBox msgBox(this);
             msgBox.setWindowTitle("Confirm Delete");
             msgBox.setText(QString("Are you sure you want to delete '%1'?")
-                          .arg(courses[row].name));
+                          .arg(session->courses[row].name));
             msgBox.setIcon(QMessageBox::Question);
             msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
             msgBox.setStyleSheet("QMessageBox{background-color: #ffffff;} QLabel{color: #000000; font-size: 11px; background-color: transparent;} QPushButton{background-color: #e0e0e0; color: #000000; font-size: 11px; min-width: 60px; padding: 5px;}");
@@ -802,7 +907,7 @@ void ManageCoursesPage::refreshTable() {
                 }
             }
 
-            // Change background for actions widget (column 5)
+            // Change background for actions widget (column 6)
             if (actionsWidget) {
                 actionsWidget->setStyleSheet(QString("background-color: %1;").arg(bgColorStr));
             }
@@ -816,7 +921,7 @@ void ManageCoursesPage::refreshTable() {
         actionsWidget->setLayout(actionsLayout);
 
         // Insert the entire widget into the table cell
-        ui->coursetable->setCellWidget(row, 5, actionsWidget);
+        ui->coursetable->setCellWidget(row, 6, actionsWidget);
     }
 
     /**
@@ -825,7 +930,7 @@ void ManageCoursesPage::refreshTable() {
      */
     if (ui->courseCountLabel) {
         ui->courseCountLabel->setText(
-            QString("View & Manage Courses (%1)").arg(courses.size()));
+            QString("View & Manage Courses (%1)").arg(session->courses.size()));
     }
 }
 
@@ -870,12 +975,12 @@ void ManageCoursesPage::clearForm() {
  */
 void ManageCoursesPage::onEditCourse(int row) {
     // Validate row index
-    if (row >= 0 && row < courses.size()) {
+    if (row >= 0 && row < session->courses.size()) {
         // Enter edit mode
         editingRow = row;
 
         // Get reference to the course being edited
-        const Course &course = courses[row];
+        const Course &course = session->courses[row];
 
         // Populate form fields with course data
         if (ui->courseNameInput) ui->courseNameInput->setText(course.name);
@@ -913,7 +1018,7 @@ void ManageCoursesPage::onEditCourse(int row) {
  */
 void ManageCoursesPage::onGenerateTimetable() {
     // Check if there are any courses to generate timetable from
-    if (courses.isEmpty()) {
+    if (session->courses.isEmpty()) {
         QMessageBox msgBox(this);
         msgBox.setWindowTitle("No Courses");
         msgBox.setText("Please add at least one course first!");
@@ -941,21 +1046,7 @@ void ManageCoursesPage::onGenerateTimetable() {
  * Opens the timetable window and populates it with course data.
  */
 void ManageCoursesPage::onLoadingComplete() {
-    // Always create a fresh timetable window to ensure data is up-to-date
-    // Delete old window if it exists
-    if (timetableWindow) {
-        delete timetableWindow;
-        timetableWindow = nullptr;
-    }
-
-    // Create new timetable window
-    timetableWindow = new TIMETABLE(this);
-
-    // Set the course data and show the timetable
-    timetableWindow->setCoursesData(courses);
-    timetableWindow->show();
-    timetableWindow->raise();
-    timetableWindow->activateWindow();
+    openTimetableWindow();
 }
 
 /**
@@ -965,7 +1056,7 @@ void ManageCoursesPage::onLoadingComplete() {
  */
 void ManageCoursesPage::onViewTimetable() {
     // Check if there are any courses to view
-    if (courses.isEmpty()) {
+    if (session->courses.isEmpty()) {
         QMessageBox msgBox(this);
         msgBox.setWindowTitle("No Courses");
         msgBox.setText("Please add courses first!");
@@ -975,6 +1066,32 @@ void ManageCoursesPage::onViewTimetable() {
         return;
     }
 
+    openTimetableWindow();
+}
+
+/**
+ * Current Time Window
+ *
+ * Index 0 of each combo box is "No limit", which maps to an empty string.
+ */
+ScheduleConstraints ManageCoursesPage::currentConstraints() const {
+    ScheduleConstraints constraints;
+    if (ui->earliestStartCombo && ui->earliestStartCombo->currentIndex() > 0) {
+        constraints.earliestStart = ui->earliestStartCombo->currentText();
+    }
+    if (ui->latestEndCombo && ui->latestEndCombo->currentIndex() > 0) {
+        constraints.latestEnd = ui->latestEndCombo->currentText();
+    }
+    return constraints;
+}
+
+/**
+ * Open Timetable Window
+ *
+ * Creates a fresh timetable window with the current courses, section
+ * preferences and time window.
+ */
+void ManageCoursesPage::openTimetableWindow() {
     // Always create a fresh timetable window to ensure data is up-to-date
     // Delete old window if it exists
     if (timetableWindow) {
@@ -984,12 +1101,61 @@ void ManageCoursesPage::onViewTimetable() {
 
     // Create new timetable window
     timetableWindow = new TIMETABLE(this);
+    timetableWindow->setGenerationCache(&generationCache);
 
     // Set the course data and show the timetable
-    timetableWindow->setCoursesData(courses);
+    timetableWindow->setCoursesData(session->courses, currentConstraints());
     timetableWindow->show();
     timetableWindow->raise();
     timetableWindow->activateWindow();
 }
 
+/**
+ * Set Session
+ *
+ * Shows the course list of the student who just logged in.
+ * Every later add, edit and delete goes to that student's session and
+ * is saved to their journal.
+ *
+ * @param studentSession: Session of the logged-in student (from SessionManager)
+ */
+void ManageCoursesPage::setSession(const QSharedPointer<StudentSession> &studentSession) {
+    editingRow = -1;
+    clearForm();
+
+    session = studentSession;
+    refreshTable();
+}
+
+/**
+ * Clear Session
+ *
+ * Called on logout. Everything is already on disk, so the page just lets
+ * go of the session; the next student starts from an empty page and
+ * can never see this student's courses.
+ */
+void ManageCoursesPage::clearSession() {
+    session = QSharedPointer<StudentSession>::create();
+    editingRow = -1;
+    clearForm();
+    refreshTable();
 
+    if (timetableWindow) {
+        delete timetableWindow;
+        timetableWindow = nullptr;
+    }
+}
+
+/**
+ * Show Store Error
+ *
+ * Tells the user a change could not be saved (and so was not made).
+ */
+void ManageCoursesPage::showStoreError() {
+    QMessageBox msgBox(this);
+    msgBox.setWindowTitle("Error");
+    msgBox.setText(QString("Failed to save your change!\n\n%1").arg(session->store.errorString()));
+    msgBox.setIcon(QMessageBox::Warning);
+    msgBox.setStyleSheet("QMessageBox{background-color: #ffffff;} QLabel{color: #000000; font-size: 11px; background-color: transparent;} QPushButton{background-color: #e0e0e0; color: #000000; font-size: 11px; min-width: 60px; padding: 5px;}");
+    msgBox.exec();
+}
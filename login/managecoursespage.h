@@ -11,15 +11,33 @@
 #include <QDialog>
 #include <QVector>
 #include <QString>
+#include <QSharedPointer>
+#include "generationcache.h"
 
+struct ScheduleConstraints;
 class MainWindow;
 class TIMETABLE;
 class LoadingDialog;
+struct StudentSession;
 
 namespace Ui {
 class ManageCoursesPage;
 }
 
+/**
+ * Section Preference
+ *
+ * How the timetable generator should treat one section of a course:
+ * - Any: may or may not be picked
+ * - Locked: must be picked (other sections of the course are dropped)
+ * - Excluded: never picked
+ */
+enum class SectionPreference {
+    Any,
+    Locked,
+    Excluded
+};
+
 /**
  * Course Structure
  *
@@ -32,6 +50,7 @@ struct Course {
     QString startTime;  // Start time in 12-hour format (e.g., "9am")
     QString endTime;    // End time in 12-hour format (e.g., "11am")
     QString classroom;  // Classroom location (e.g., "Room 301")
+    SectionPreference preference = SectionPreference::Any;  // Lock/exclude this section
 };
 
 /**
@@ -63,6 +82,23 @@ public:
      */
     ~ManageCoursesPage();
 
+    /**
+     * Shows and edits the courses of a student's session (called after login)
+     * @param studentSession: Session from MainWindow's SessionManager
+     */
+    void setSession(const QSharedPointer<StudentSession> &studentSession);
+
+    /**
+     * Lets go of the student's session and clears the page (called on logout)
+     */
+    void clearSession();
+
+protected:
+    /**
+     * Times whole-window repaints when tracing is on (see Tracer)
+     */
+    bool event(QEvent *event) override;
+
 private slots:
     // Slot functions that respond to user actions
 
@@ -129,15 +165,40 @@ private:
      */
     int timeToInt(const QString &time);
 
+    /**
+     * Reads the earliest start / latest end combo boxes
+     * Empty strings mean "no limit"
+     */
+    ScheduleConstraints currentConstraints() const;
+
+    /**
+     * Opens a new timetable window for the current courses and constraints
+     * Shared by the Generate and View buttons
+     */
+    void openTimetableWindow();
+
+    /**
+     * Shows a warning that a change could not be saved
+     */
+    void showStoreError();
+
     // Private member variables
 
     Ui::ManageCoursesPage *ui;  // Pointer to UI components
 
     /**
-     * Vector (dynamic array) storing all course data
-     * Each element is a Course struct containing course details
+     * Session of the logged-in student (an empty one when logged out)
+     * session->courses is the vector (dynamic array) storing all course
+     * data; session->store is its on-disk journal, and every change to
+     * the courses is recorded there first
+     */
+    QSharedPointer<StudentSession> session;
+
+    /**
+     * Generation results by course set, shared by the Generate and
+     * View buttons and kept on disk between sessions
      */
-    QVector<Course> courses;
+    GenerationCache generationCache;
 
     /**
      * Edit Mode Tracking Variable
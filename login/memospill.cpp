@@ -0,0 +1,157 @@
+/**
+ * MemoSpill Implementation File
+ *
+ * Implements the mapped hash table and its growth.
+ */
+
+#include "memospill.h"
+#include <QTemporaryFile>
+#include <QDir>
+
+namespace {
+
+const quint64 InitialCapacity = 1 << 20;  // 24 MB file
+
+} // namespace
+
+MemoSpill::MemoSpill()
+    : records(nullptr)
+    , capacity(0)
+    , used(0)
+{
+}
+
+MemoSpill::~MemoSpill()
+{
+    // QTemporaryFile unmaps and deletes the file
+}
+
+bool MemoSpill::open()
+{
+    QWriteLocker locker(&lock);
+    if (!mapNew(file, records, InitialCapacity)) return false;
+
+    capacity = InitialCapacity;
+    used = 0;
+    return true;
+}
+
+// A new, zero-filled (= empty) table in its own temporary file
+bool MemoSpill::mapNew(QScopedPointer<QTemporaryFile> &newFile, Record *&newRecords, quint64 newCapacity)
+{
+    newFile.reset(new QTemporaryFile(QDir::temp().filePath("timetable-memo-XXXXXX.spill")));
+    const qint64 bytes = qint64(newCapacity * sizeof(Record));
+
+    if (!newFile->open() || !newFile->resize(bytes)) {
+        error = QString("Cannot create %1: %2").arg(newFile->fileName(), newFile->errorString());
+        newFile.reset();
+        return false;
+    }
+
+    uchar *map = newFile->map(0, bytes);
+    if (!map) {
+        error = QString("Cannot map %1: %2").arg(newFile->fileName(), newFile->errorString());
+        newFile.reset();
+        return false;
+    }
+
+    newRecords = reinterpret_cast<Record *>(map);
+    return true;
+}
+
+// splitmix64 finaliser over both words, reduced to the table size
+quint64 MemoSpill::slotFor(quint64 low, quint64 high, quint64 tableSize)
+{
+    quint64 x = low ^ (high * 0x9E3779B97F4A7C15ULL);
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x & (tableSize - 1);
+}
+
+bool MemoSpill::find(quint64 low, quint64 high, quint64 &count) const
+{
+    QReadLocker locker(&lock);
+    if (!records) return false;
+
+    for (quint64 slot = slotFor(low, high, capacity);; slot = (slot + 1) & (capacity - 1)) {
+        const Record &record = records[slot];
+        if (record.highPlusOne == 0) return false;
+        if (record.low == low && record.highPlusOne == high + 1) {
+            count = record.count;
+            return true;
+        }
+    }
+}
+
+bool MemoSpill::insert(quint64 low, quint64 high, quint64 count)
+{
+    QWriteLocker locker(&lock);
+    if (!records) return false;
+    if (quint64(used + 1) * 2 > capacity && !grow()) return false;
+
+    for (quint64 slot = slotFor(low, high, capacity);; slot = (slot + 1) & (capacity - 1)) {
+        Record &record = records[slot];
+        if (record.highPlusOne == 0) {
+            record = { low, high + 1, count };
+            used++;
+            return true;
+        }
+        if (record.low == low && record.highPlusOne == high + 1) {
+            record.count = count;
+            return true;
+        }
+    }
+}
+
+// Rehashes into a file twice the size; the old file is deleted afterwards
+bool MemoSpill::grow()
+{
+    QScopedPointer<QTemporaryFile> newFile;
+    Record *newRecords = nullptr;
+    const quint64 newCapacity = capacity * 2;
+    if (!mapNew(newFile, newRecords, newCapacity)) return false;
+
+    for (quint64 i = 0; i < capacity; ++i) {
+        const Record &record = records[i];
+        if (record.highPlusOne == 0) continue;
+
+        quint64 slot = slotFor(record.low, record.highPlusOne - 1, newCapacity);
+        while (newRecords[slot].highPlusOne != 0) slot = (slot + 1) & (newCapacity - 1);
+        newRecords[slot] = record;
+    }
+
+    file.swap(newFile);
+    records = newRecords;
+    capacity = newCapacity;
+    return true;
+}
+
+qsizetype MemoSpill::size() const
+{
+    QReadLocker locker(&lock);
+    return used;
+}
+
+qint64 MemoSpill::fileBytes() const
+{
+    QReadLocker locker(&lock);
+    return qint64(capacity * sizeof(Record));
+}
+
+QString MemoSpill::errorString() const
+{
+    QReadLocker locker(&lock);
+    return error;
+}
+
+void MemoSpill::forEach(const std::function<void(quint64, quint64, quint64)> &visit) const
+{
+    QReadLocker locker(&lock);
+    for (quint64 i = 0; i < capacity; ++i) {
+        const Record &record = records[i];
+        if (record.highPlusOne != 0) visit(record.low, record.highPlusOne - 1, record.count);
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * MemoSpill Header File
+ *
+ * This file defines the on-disk overflow for the engine memo: counts
+ * that no longer fit the memory budget live in a memory-mapped
+ * temporary file instead of the heap.
+ */
+
+#ifndef MEMOSPILL_H
+#define MEMOSPILL_H
+
+#include <QString>
+#include <QScopedPointer>
+#include <QReadWriteLock>
+#include <functional>
+
+class QTemporaryFile;
+
+/**
+ * MemoSpill Class
+ *
+ * An open-addressing hash table (linear probing) of fixed 24-byte
+ * records stored straight in a mapped temporary file. The operating
+ * system pages records in when they are looked up and writes cold pages
+ * back to the file, so the table can be much larger than the memory the
+ * process keeps resident. The file is deleted when the table is.
+ *
+ * Engine copies (e.g. the exporter's) read the original engine's table
+ * while it keeps writing to it. A read/write lock makes that safe across
+ * threads.
+ */
+class MemoSpill {
+public:
+    MemoSpill();
+    ~MemoSpill();
+
+    /**
+     * Creates the temporary file
+     * @return false if it could not be created or mapped (see errorString())
+     */
+    bool open();
+
+    bool find(quint64 low, quint64 high, quint64 &count) const;
+
+    /**
+     * Adds or overwrites one count; grows (rehashes into a file twice
+     * the size) when the table is half full
+     * @return false if growing failed; the count is then not stored
+     */
+    bool insert(quint64 low, quint64 high, quint64 count);
+
+    qsizetype size() const;
+    qint64 fileBytes() const;
+    QString errorString() const;
+
+    void forEach(const std::function<void(quint64 low, quint64 high, quint64 count)> &visit) const;
+
+private:
+    /**
+     * highPlusOne is 0 for an empty slot: a new file reads as all zeros,
+     * and key.high is never all ones (the group index is in its top bits)
+     */
+    struct Record {
+        quint64 low;
+        quint64 highPlusOne;
+        quint64 count;
+    };
+
+    bool mapNew(QScopedPointer<QTemporaryFile> &newFile, Record *&newRecords, quint64 newCapacity);
+    bool grow();
+    static quint64 slotFor(quint64 low, quint64 high, quint64 tableSize);
+
+    QScopedPointer<QTemporaryFile> file;
+    Record *records;
+    quint64 capacity;  // Slots, always a power of two
+    qsizetype used;
+    QString error;
+    mutable QReadWriteLock lock;
+};
+
+#endif // MEMOSPILL_H
@@ -0,0 +1,95 @@
+/**
+ * PerfMetrics Implementation File
+ *
+ * Implements the lock-free metric slots and the overlay text.
+ */
+
+#include "perfmetrics.h"
+#include <QStringList>
+#include <atomic>
+
+namespace {
+
+const int SlotCount = static_cast<int>(Metric::MetricCount);
+
+struct Slot {
+    std::atomic<qint64> calls{0};
+    std::atomic<qint64> value{0};
+    std::atomic<qint64> last{0};
+};
+
+Slot metricSlots[SlotCount];
+
+const char *const MetricNames[SlotCount] = {
+    "generate", "engine setup", "engine count", "unrank page", "optimizer slice",
+    "detect conflicts", "populate timetable", "update statistics", "render page", "save as",
+    "nodes explored", "memo hits", "branches pruned", "page cache hits"
+};
+
+bool isTimer(int index)
+{
+    return index < static_cast<int>(Metric::NodesExplored);
+}
+
+} // namespace
+
+void PerfMetrics::addTime(Metric metric, qint64 nanoseconds)
+{
+    Slot &slot = metricSlots[static_cast<int>(metric)];
+    slot.calls.fetch_add(1, std::memory_order_relaxed);
+    slot.value.fetch_add(nanoseconds, std::memory_order_relaxed);
+    slot.last.store(nanoseconds, std::memory_order_relaxed);
+}
+
+void PerfMetrics::addCount(Metric metric, qint64 amount)
+{
+    Slot &slot = metricSlots[static_cast<int>(metric)];
+    slot.calls.fetch_add(1, std::memory_order_relaxed);
+    slot.value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+qint64 PerfMetrics::calls(Metric metric)
+{
+    return metricSlots[static_cast<int>(metric)].calls.load(std::memory_order_relaxed);
+}
+
+qint64 PerfMetrics::value(Metric metric)
+{
+    return metricSlots[static_cast<int>(metric)].value.load(std::memory_order_relaxed);
+}
+
+const char *PerfMetrics::name(Metric metric)
+{
+    return MetricNames[static_cast<int>(metric)];
+}
+
+// e.g. "render page        12x  total 48.20 ms  last 3.91 ms"
+QString PerfMetrics::summary()
+{
+    QStringList lines;
+    for (int i = 0; i < SlotCount; ++i) {
+        const qint64 calls = metricSlots[i].calls.load(std::memory_order_relaxed);
+        if (calls == 0) continue;
+
+        const qint64 value = metricSlots[i].value.load(std::memory_order_relaxed);
+        if (isTimer(i)) {
+            lines.append(QString("%1 %2x  total %3 ms  last %4 ms")
+                             .arg(QString::fromLatin1(MetricNames[i]), -20)
+                             .arg(calls, 6)
+                             .arg(value / 1e6, 9, 'f', 2)
+                             .arg(metricSlots[i].last.load(std::memory_order_relaxed) / 1e6, 7, 'f', 2));
+        } else {
+            lines.append(QString("%1 %2").arg(QString::fromLatin1(MetricNames[i]), -20).arg(value, 14));
+        }
+    }
+    return lines.join('\n');
+}
+
+void PerfMetrics::reset()
+{
+    for (Slot &slot : metricSlots) {
+        slot.calls.store(0, std::memory_order_relaxed);
+        slot.value.store(0, std::memory_order_relaxed);
+        slot.last.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,94 @@
+/**
+ * PerfMetrics Header File
+ *
+ * This file defines the timers and counters placed on the hot paths
+ * between clicking Generate and seeing the grid, and the registry that
+ * adds them up.
+ *
+ * Build with "qmake CONFIG+=metrics" to turn them on. In a normal build
+ * METRICS_SCOPE and METRICS_COUNT expand to nothing, and their arguments
+ * are never evaluated.
+ */
+
+#ifndef PERFMETRICS_H
+#define PERFMETRICS_H
+
+#include <QString>
+#include <QElapsedTimer>
+
+/**
+ * Everything that is measured: the timers first, then the plain counters
+ */
+enum class Metric {
+    // timers (calls, total and last time)
+    Generate,           // TIMETABLE::setCoursesData, end to end
+    EngineSetup,        // TimetableEngine::setCourses
+    EngineCount,        // first validCount() after setup: the DP count
+    Unrank,             // TimetableEngine::choicesAt
+    OptimizerRun,       // one optimizer slice
+    DetectConflicts,
+    PopulateTimetable,
+    UpdateStatistics,
+    RenderPage,         // TIMETABLE::renderedPage on a cache miss
+    SaveAs,             // rendering and writing the file, on the worker
+
+    // counters
+    NodesExplored,      // DP states computed
+    MemoHits,           // DP states answered from the memo
+    BranchesPruned,     // sections skipped because they overlap a choice
+    PageCacheHits,
+
+    MetricCount
+};
+
+/**
+ * PerfMetrics Class
+ *
+ * One fixed slot per Metric, updated with relaxed atomics, so any
+ * thread can record without a lock and the lookup is an array index.
+ */
+class PerfMetrics {
+public:
+    static void addTime(Metric metric, qint64 nanoseconds);
+    static void addCount(Metric metric, qint64 amount);
+
+    static qint64 calls(Metric metric);
+    static qint64 value(Metric metric);  // Total ns for timers, count for counters
+
+    /**
+     * One line per metric that has been recorded, for the debug overlay
+     */
+    static QString summary();
+    static void reset();
+
+    static const char *name(Metric metric);
+};
+
+/**
+ * Records the time from construction to the end of the scope
+ */
+class PerfTimer {
+public:
+    explicit PerfTimer(Metric metric) : metric(metric) { timer.start(); }
+    ~PerfTimer() { PerfMetrics::addTime(metric, timer.nsecsElapsed()); }
+
+    PerfTimer(const PerfTimer &) = delete;
+    PerfTimer &operator=(const PerfTimer &) = delete;
+
+private:
+    Metric metric;
+    QElapsedTimer timer;
+};
+
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+
+#ifdef TIMETABLE_METRICS
+#define METRICS_SCOPE(metric) PerfTimer PERF_CONCAT(perfTimer, __LINE__)(metric)
+#define METRICS_COUNT(metric, amount) PerfMetrics::addCount(metric, amount)
+#else
+#define METRICS_SCOPE(metric) ((void)0)
+#define METRICS_COUNT(metric, amount) ((void)0)
+#endif
+
+#endif // PERFMETRICS_H
@@ -0,0 +1,152 @@
+/**
+ * RegistrarScheduler Implementation File
+ *
+ * Implements greedy best-fit room placement over occupancy bitmaps.
+ */
+
+#include "registrarscheduler.h"
+#include "timetableengine.h"
+#include <algorithm>
+
+namespace {
+
+// Latest end column a section can have: hourIndex() reads 8am to 9pm, so
+// a section ending later could not be written back as a time string
+const int LastEndHour = TimetableEngine::HourCount - 1;
+
+// hours [startHour, endHour) as bits of a day mask
+quint16 hourMask(int startHour, int endHour)
+{
+    return quint16(((1u << (endHour - startHour)) - 1) << startHour);
+}
+
+bool isFlexible(const RegistrarSection &section)
+{
+    return section.day.trimmed().isEmpty();
+}
+
+} // namespace
+
+RegistrarScheduler::RegistrarScheduler()
+{
+}
+
+void RegistrarScheduler::setRooms(const QVector<Room> &newRooms)
+{
+    rooms = newRooms;
+
+    // name -> index for preferred-room lookups; the first room of a name wins
+    roomIndex.clear();
+    roomIndex.reserve(rooms.size());
+    for (int i = 0; i < rooms.size(); ++i) {
+        if (!roomIndex.contains(rooms[i].name)) roomIndex.insert(rooms[i].name, i);
+    }
+
+    roomsByCapacity.resize(rooms.size());
+    for (int i = 0; i < rooms.size(); ++i) roomsByCapacity[i] = i;
+    std::stable_sort(roomsByCapacity.begin(), roomsByCapacity.end(), [this](int a, int b) {
+        return rooms[a].capacity < rooms[b].capacity;
+    });
+}
+
+QString RegistrarScheduler::hourLabel(int hourIndex)
+{
+    const int hour = hourIndex + 8;
+    if (hour < 12) return QString("%1am").arg(hour);
+    if (hour == 12) return QString("12pm");
+    return QString("%1pm").arg(hour - 12);
+}
+
+RegistrarResult RegistrarScheduler::schedule(const QVector<RegistrarSection> &sections)
+{
+    occupancy.fill(0, rooms.size() * TimetableEngine::DayCount);
+
+    RegistrarResult result;
+    result.assignments.resize(sections.size());
+
+    // Hardest first: fixed times, then big enrollments, then long sections
+    QVector<int> order(sections.size());
+    for (int i = 0; i < sections.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&sections](int a, int b) {
+        const RegistrarSection &x = sections[a];
+        const RegistrarSection &y = sections[b];
+        if (isFlexible(x) != isFlexible(y)) return !isFlexible(x);
+        if (x.enrollment != y.enrollment) return x.enrollment > y.enrollment;
+        return x.hours > y.hours;
+    });
+
+    for (int index : order) {
+        if (place(sections[index], result.assignments[index])) {
+            result.placed++;
+        } else {
+            result.assignments[index] = RoomAssignment();
+            result.unplaced++;
+        }
+    }
+    return result;
+}
+
+bool RegistrarScheduler::place(const RegistrarSection &section, RoomAssignment &assignment)
+{
+    const int first = firstRoomFitting(section.enrollment);
+    if (first < 0) return false;  // no room is big enough
+
+    // preferred room first, if it exists and is big enough
+    int preferred = section.preferredRoom.isEmpty() ? -1 : roomIndex.value(section.preferredRoom, -1);
+    if (preferred >= 0 && rooms[preferred].capacity < section.enrollment) preferred = -1;
+
+    if (!isFlexible(section)) {
+        const int day = TimetableEngine::dayIndex(section.day);
+        const int startHour = TimetableEngine::hourIndex(section.startTime);
+        const int endHour = TimetableEngine::hourIndex(section.endTime);
+        if (day < 0 || startHour < 0 || endHour <= startHour) return false;
+
+        if (preferred >= 0 && tryRoom(preferred, day, startHour, endHour, assignment)) return true;
+        for (int i = first; i < roomsByCapacity.size(); ++i) {
+            if (tryRoom(roomsByCapacity[i], day, startHour, endHour, assignment)) return true;
+        }
+        return false;
+    }
+
+    // Flexible: earliest free slot, preferred room first, then best fit
+    const int hours = section.hours;
+    if (hours <= 0 || hours > LastEndHour) return false;
+
+    auto tryAnyTime = [&](int room) {
+        for (int day = 0; day < TimetableEngine::DayCount; ++day) {
+            for (int start = 0; start + hours <= LastEndHour; ++start) {
+                if (tryRoom(room, day, start, start + hours, assignment)) return true;
+            }
+        }
+        return false;
+    };
+
+    if (preferred >= 0 && tryAnyTime(preferred)) return true;
+    for (int i = first; i < roomsByCapacity.size(); ++i) {
+        if (tryAnyTime(roomsByCapacity[i])) return true;
+    }
+    return false;
+}
+
+// Books the room if those hours are free: one AND to test, one OR to book
+bool RegistrarScheduler::tryRoom(int room, int day, int startHour, int endHour, RoomAssignment &assignment)
+{
+    quint16 &dayMask = occupancy[room * TimetableEngine::DayCount + day];
+    const quint16 mask = hourMask(startHour, endHour);
+    if (dayMask & mask) return false;
+
+    dayMask |= mask;
+    assignment.room = room;
+    assignment.day = day;
+    assignment.startHour = startHour;
+    assignment.endHour = endHour;
+    return true;
+}
+
+// Position in roomsByCapacity of the smallest room holding enrollment, -1 if none
+int RegistrarScheduler::firstRoomFitting(int enrollment) const
+{
+    auto it = std::lower_bound(roomsByCapacity.begin(), roomsByCapacity.end(), enrollment,
+                               [this](int room, int value) { return rooms[room].capacity < value; });
+    return it == roomsByCapacity.end() ? -1 : int(it - roomsByCapacity.begin());
+}
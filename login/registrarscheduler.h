@@ -0,0 +1,96 @@
+/**
+ * RegistrarScheduler Header File
+ *
+ * This file defines the registrar engine that places many sections into
+ * a shared set of rooms, producing one clash-free master timetable.
+ */
+
+#ifndef REGISTRARSCHEDULER_H
+#define REGISTRARSCHEDULER_H
+
+#include <QVector>
+#include <QString>
+#include <QHash>
+
+/**
+ * A teaching room
+ */
+struct Room {
+    QString name;
+    int capacity = 0;
+};
+
+/**
+ * One section to place
+ *
+ * A section with a day and times keeps them and only needs a room.
+ * A section without a day is placed at any free time, for `hours` hours.
+ */
+struct RegistrarSection {
+    QString course;
+    QString day;            // e.g. "Monday"; empty = any day
+    QString startTime;      // e.g. "9am"; empty when day is empty
+    QString endTime;
+    int hours = 0;          // length, only used when day is empty
+    int enrollment = 0;     // students; the room must hold them all
+    QString preferredRoom;  // tried first if it is big enough
+};
+
+/**
+ * Where one section ended up (room -1 = could not be placed)
+ */
+struct RoomAssignment {
+    int room = -1;       // index into the rooms given to setRooms()
+    int day = -1;        // 0 = Monday
+    int startHour = -1;  // hour column, 0 = 8am
+    int endHour = -1;    // exclusive
+};
+
+struct RegistrarResult {
+    QVector<RoomAssignment> assignments;  // Same order as the sections
+    int placed = 0;
+    int unplaced = 0;
+};
+
+/**
+ * RegistrarScheduler Class
+ *
+ * Each room's week is stored the same way TimetableEngine stores a
+ * student's week: seven 16-bit hour masks. Checking whether a room is
+ * free for a section is one AND, and booking it is one OR.
+ *
+ * Sections are placed greedily, hardest first: fixed-time sections
+ * before flexible ones, and within each the largest enrollment first
+ * (big rooms are scarce). Each section takes its preferred room if that
+ * fits, otherwise the smallest free room that is big enough (best fit),
+ * which keeps big rooms available for big sections.
+ */
+class RegistrarScheduler {
+public:
+    RegistrarScheduler();
+
+    void setRooms(const QVector<Room> &rooms);
+
+    /**
+     * Places every section it can; never double-books a room
+     */
+    RegistrarResult schedule(const QVector<RegistrarSection> &sections);
+
+    /**
+     * Hour column -> time string ("8am", "1pm"), the inverse of
+     * TimetableEngine::hourIndex() for 8am to 9pm
+     */
+    static QString hourLabel(int hourIndex);
+
+private:
+    bool place(const RegistrarSection &section, RoomAssignment &assignment);
+    bool tryRoom(int room, int day, int startHour, int endHour, RoomAssignment &assignment);
+    int firstRoomFitting(int enrollment) const;
+
+    QVector<Room> rooms;            // As given
+    QHash<QString, int> roomIndex;  // Room name -> index
+    QVector<int> roomsByCapacity;   // Room indexes, smallest first
+    QVector<quint16> occupancy;     // rooms x 7 day masks
+};
+
+#endif // REGISTRARSCHEDULER_H
@@ -0,0 +1,596 @@
+/**
+ * SchedulingServer Implementation File
+ *
+ * Implements the JSON protocol, request dispatch and server counters.
+ */
+
+#include "schedulingserver.h"
+#include "managecoursespage.h"
+#include "timetableengine.h"
+#include "timetableoptimizer.h"
+#include "registrarscheduler.h"
+#include "clashanalyzer.h"
+#include "examscheduler.h"
+#include "tracer.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QPointer>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+
+namespace {
+
+const qint64 MaxRequestBytes = 1024 * 1024;  // longer lines are rejected
+const int MaxCoursesPerRequest = 2000;
+const int MaxTimetablesPerRequest = 100;
+const quint64 RankWindow = 5000;             // pages scored when ranking
+const int OptimizerBudgetMs = 30;
+const qint64 CountDeadlineMs = 5000;         // default limit on counting time
+const qint64 MaxCountDeadlineMs = 30000;
+const qint64 RequestMemoryBudget = 64LL * 1024 * 1024;  // memo per request, spills beyond
+const int LatencySamples = 1024;             // latencies kept for percentiles
+const int RateWindowMs = 10000;              // requests/s over the last 10 s
+
+const int MaxRooms = 5000;
+const int MaxRegistrarSections = 50000;
+const int MaxStudents = 200000;
+const int MaxClashesPerRequest = 1000;
+const int ExamBudgetMs = 2000;               // default tabu search time
+const int MaxExamBudgetMs = 20000;
+
+const char *const PreferenceNames[] = { "any", "locked", "excluded" };
+
+const char *const DayNames[TimetableEngine::DayCount] = {
+    "Monday", "Tuesday", "Wednesday", "Thursday",
+    "Friday", "Saturday", "Sunday"
+};
+
+QJsonObject errorReply(const QString &message)
+{
+    QJsonObject reply;
+    reply["ok"] = false;
+    reply["error"] = message;
+    return reply;
+}
+
+// Answers once and hangs up: the rest of an over-long line is not parsed
+void rejectLongLine(QLocalSocket *socket)
+{
+    const QJsonObject reply = errorReply(QString("Request is longer than %1 bytes").arg(MaxRequestBytes));
+    socket->write(QJsonDocument(reply).toJson(QJsonDocument::Compact) + '\n');
+    socket->disconnectFromServer();
+}
+
+QJsonObject courseToJson(const Course &course)
+{
+    QJsonObject object;
+    object["name"] = course.name;
+    object["day"] = course.day;
+    object["startTime"] = course.startTime;
+    object["endTime"] = course.endTime;
+    object["classroom"] = course.classroom;
+    object["preference"] = PreferenceNames[static_cast<int>(course.preference)];
+    return object;
+}
+
+bool courseFromJson(const QJsonValue &value, Course &course, QString &error)
+{
+    const QJsonObject object = value.toObject();
+    course.name = object["name"].toString().trimmed();
+    course.day = object["day"].toString();
+    course.startTime = object["startTime"].toString();
+    course.endTime = object["endTime"].toString();
+    course.classroom = object["classroom"].toString();
+
+    if (course.name.isEmpty() || TimetableEngine::dayIndex(course.day) < 0) {
+        error = "Every course needs a name and a valid day";
+        return false;
+    }
+
+    const QString preference = object["preference"].toString("any").toLower();
+    if (preference == "locked") {
+        course.preference = SectionPreference::Locked;
+    } else if (preference == "excluded") {
+        course.preference = SectionPreference::Excluded;
+    } else if (preference == "any") {
+        course.preference = SectionPreference::Any;
+    } else {
+        error = QString("Unknown preference '%1'").arg(preference);
+        return false;
+    }
+    return true;
+}
+
+// Reads "courses" and "constraints" into engine input
+bool readProblem(const QJsonObject &request, QVector<Course> &courses,
+                 ScheduleConstraints &constraints, QString &error)
+{
+    const QJsonArray array = request["courses"].toArray();
+    if (array.isEmpty()) {
+        error = "No courses given";
+        return false;
+    }
+    if (array.size() > MaxCoursesPerRequest) {
+        error = QString("At most %1 courses per request").arg(MaxCoursesPerRequest);
+        return false;
+    }
+
+    courses.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        Course course;
+        if (!courseFromJson(value, course, error)) return false;
+        courses.append(course);
+    }
+
+    const QJsonObject limits = request["constraints"].toObject();
+    constraints.earliestStart = limits["earliestStart"].toString();
+    constraints.latestEnd = limits["latestEnd"].toString();
+    return true;
+}
+
+// Reads "limits" ({maxResults, maxNodes, deadlineMs}); counting always has
+// a deadline, so no request can hold a pool thread for long
+GenerationLimits readLimits(const QJsonObject &request)
+{
+    const QJsonObject object = request["limits"].toObject();
+
+    GenerationLimits limits;
+    limits.maxResults = quint64(qMax<qint64>(0, object["maxResults"].toInteger(0)));
+    limits.maxNodes = quint64(qMax<qint64>(0, object["maxNodes"].toInteger(0)));
+    limits.deadlineMs = qBound<qint64>(1, object["deadlineMs"].toInteger(CountDeadlineMs), MaxCountDeadlineMs);
+    return limits;
+}
+
+// "total" is what can be paged through; "truncated" says a limit cut it
+// short, and "estimatedTotal" how many there are in all
+void addCountFields(QJsonObject &reply, TimetableEngine &engine)
+{
+    reply["total"] = QString::number(engine.validCount());  // may not fit a JSON double
+    reply["truncated"] = engine.isTruncated();
+    reply["estimatedTotal"] = QString::number(engine.estimatedTotal());
+}
+
+QJsonObject scoreToJson(const OptimizerScore &score)
+{
+    QJsonObject object;
+    object["conflicts"] = score.conflicts;
+    object["totalHours"] = score.totalHours;
+    object["gapHours"] = score.gapHours;
+    object["activeDays"] = score.activeDays;
+    return object;
+}
+
+QJsonObject handleCount(const QJsonObject &request)
+{
+    QVector<Course> courses;
+    ScheduleConstraints constraints;
+    QString error;
+    if (!readProblem(request, courses, constraints, error)) return errorReply(error);
+
+    TimetableEngine engine;
+    engine.setMemoryBudget(RequestMemoryBudget);  // one per pool thread at worst
+    engine.setCourses(courses, constraints);
+    engine.setLimits(readLimits(request));
+
+    const PruneReport &report = engine.pruneReport();
+    QJsonObject pruned;
+    pruned["excluded"] = report.excludedSections;
+    pruned["lockedOut"] = report.lockedOutSections;
+    pruned["outsideTimeWindow"] = report.outsideTimeWindow;
+    pruned["emptyCourses"] = report.emptyGroups;
+
+    QJsonObject reply;
+    reply["ok"] = true;
+    addCountFields(reply, engine);
+    reply["pruned"] = pruned;
+    return reply;
+}
+
+// Ranks timetables best first: every page of small problems is scored;
+// big problems are ranked over their first RankWindow pages, plus the
+// optimizer's best answer, which may lie anywhere
+QJsonObject handleTimetables(const QJsonObject &request)
+{
+    QVector<Course> courses;
+    ScheduleConstraints constraints;
+    QString error;
+    if (!readProblem(request, courses, constraints, error)) return errorReply(error);
+
+    const int offset = qMax(0, request["offset"].toInt(0));
+    const int limit = qBound(1, request["limit"].toInt(10), MaxTimetablesPerRequest);
+
+    TimetableEngine engine;
+    engine.setMemoryBudget(RequestMemoryBudget);  // one per pool thread at worst
+    engine.setCourses(courses, constraints);
+    engine.setLimits(readLimits(request));
+    const quint64 total = engine.validCount();
+
+    TimetableOptimizer optimizer;
+    optimizer.setProblem(engine);
+    optimizer.run(OptimizerBudgetMs);
+
+    struct Ranked {
+        quint64 page;
+        QVector<int> choices;
+        OptimizerScore score;
+    };
+    QVector<Ranked> ranked;
+
+    const quint64 scanned = qMin(total, RankWindow);
+    ranked.reserve(int(scanned) + 1);
+    for (quint64 page = 0; page < scanned; ++page) {
+        QVector<int> choices = engine.choicesAt(page);
+        ranked.append({ page, choices, optimizer.scoreOf(choices) });
+    }
+    if (optimizer.hasConflictFreeResult()) {
+        const quint64 bestPage = engine.rankOf(optimizer.bestChoices());
+        if (bestPage >= scanned && bestPage < total &&
+            engine.choicesAt(bestPage) == optimizer.bestChoices()) {
+            ranked.append({ bestPage, optimizer.bestChoices(), optimizer.bestScore() });
+        }
+    }
+
+    std::stable_sort(ranked.begin(), ranked.end(), [](const Ranked &a, const Ranked &b) {
+        return a.score.cost() < b.score.cost();
+    });
+
+    QJsonArray timetables;
+    for (int i = offset; i < ranked.size() && i < offset + limit; ++i) {
+        QJsonArray pageCourses;
+        for (const Course &course : engine.combinationFromChoices(ranked[i].choices)) {
+            pageCourses.append(courseToJson(course));
+        }
+
+        QJsonObject timetable;
+        timetable["page"] = QString::number(ranked[i].page + 1);
+        timetable["score"] = scoreToJson(ranked[i].score);
+        timetable["courses"] = pageCourses;
+        timetables.append(timetable);
+    }
+
+    QJsonObject reply;
+    reply["ok"] = true;
+    addCountFields(reply, engine);
+    reply["ranked"] = ranked.size();
+    reply["timetables"] = timetables;
+    return reply;
+}
+
+// Registrar mode: places every section of a department into shared rooms
+QJsonObject handleAssignRooms(const QJsonObject &request)
+{
+    const QJsonArray roomArray = request["rooms"].toArray();
+    const QJsonArray sectionArray = request["sections"].toArray();
+    if (roomArray.isEmpty() || sectionArray.isEmpty()) {
+        return errorReply("Both rooms and sections are needed");
+    }
+    if (roomArray.size() > MaxRooms || sectionArray.size() > MaxRegistrarSections) {
+        return errorReply(QString("At most %1 rooms and %2 sections per request")
+                              .arg(MaxRooms).arg(MaxRegistrarSections));
+    }
+
+    QVector<Room> rooms;
+    rooms.reserve(roomArray.size());
+    for (const QJsonValue &value : roomArray) {
+        const QJsonObject object = value.toObject();
+        rooms.append({ object["name"].toString(), object["capacity"].toInt() });
+    }
+
+    QVector<RegistrarSection> sections;
+    sections.reserve(sectionArray.size());
+    for (const QJsonValue &value : sectionArray) {
+        const QJsonObject object = value.toObject();
+        RegistrarSection section;
+        section.course = object["course"].toString();
+        section.day = object["day"].toString();
+        section.startTime = object["startTime"].toString();
+        section.endTime = object["endTime"].toString();
+        section.hours = object["hours"].toInt();
+        section.enrollment = object["enrollment"].toInt();
+        section.preferredRoom = object["room"].toString();
+        sections.append(section);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    RegistrarScheduler scheduler;
+    scheduler.setRooms(rooms);
+    const RegistrarResult result = scheduler.schedule(sections);
+
+    QJsonArray assignments;
+    QJsonArray unplaced;
+    for (int i = 0; i < sections.size(); ++i) {
+        const RoomAssignment &assignment = result.assignments[i];
+        if (assignment.room < 0) {
+            unplaced.append(i);
+            continue;
+        }
+
+        QJsonObject object;
+        object["section"] = i;
+        object["course"] = sections[i].course;
+        object["room"] = rooms[assignment.room].name;
+        object["day"] = DayNames[assignment.day];
+        object["startTime"] = RegistrarScheduler::hourLabel(assignment.startHour);
+        object["endTime"] = RegistrarScheduler::hourLabel(assignment.endHour);
+        assignments.append(object);
+    }
+
+    QJsonObject reply;
+    reply["ok"] = true;
+    reply["placed"] = result.placed;
+    reply["unplaced"] = result.unplaced;
+    reply["elapsedMs"] = timer.elapsed();
+    reply["assignments"] = assignments;
+    reply["unplacedSections"] = unplaced;
+    return reply;
+}
+
+// Department clash analysis: which overlapping sections hit how many students
+QJsonObject handleClashes(const QJsonObject &request)
+{
+    const QJsonArray sectionArray = request["sections"].toArray();
+    const QJsonArray studentArray = request["students"].toArray();
+    if (sectionArray.isEmpty() || studentArray.isEmpty()) {
+        return errorReply("Both sections and students are needed");
+    }
+    if (sectionArray.size() > MaxRegistrarSections || studentArray.size() > MaxStudents) {
+        return errorReply(QString("At most %1 sections and %2 students per request")
+                              .arg(MaxRegistrarSections).arg(MaxStudents));
+    }
+
+    QVector<Course> sections;
+    sections.reserve(sectionArray.size());
+    for (const QJsonValue &value : sectionArray) {
+        const QJsonObject object = value.toObject();
+        Course section;
+        section.name = object["course"].toString().trimmed();
+        section.day = object["day"].toString();
+        section.startTime = object["startTime"].toString();
+        section.endTime = object["endTime"].toString();
+        sections.append(section);
+    }
+
+    QVector<QStringList> enrollments;
+    enrollments.reserve(studentArray.size());
+    for (const QJsonValue &value : studentArray) {
+        QStringList courseNames;
+        for (const QJsonValue &name : value.toArray()) courseNames.append(name.toString().trimmed());
+        enrollments.append(courseNames);
+    }
+
+    const int limit = qBound(1, request["limit"].toInt(100), MaxClashesPerRequest);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ClashAnalyzer analyzer;
+    const ClashReport report = analyzer.analyze(sections, enrollments);
+
+    QJsonArray clashes;
+    for (int i = 0; i < report.clashes.size() && i < limit; ++i) {
+        const SectionClash &clash = report.clashes[i];
+        QJsonObject object;
+        object["first"] = clash.first;
+        object["second"] = clash.second;
+        object["courses"] = QJsonArray{ sections[clash.first].name, sections[clash.second].name };
+        object["day"] = sections[clash.first].day;
+        object["students"] = clash.students;
+        clashes.append(object);
+    }
+
+    QJsonObject reply;
+    reply["ok"] = true;
+    reply["courses"] = report.courseCount;
+    reply["coursePairsChecked"] = report.coursePairsChecked;
+    reply["clashingSectionPairs"] = report.clashes.size();
+    reply["sharedEnrollment"] = report.sharedEnrollment;
+    reply["elapsedMs"] = timer.elapsed();
+    reply["clashes"] = clashes;
+    return reply;
+}
+
+// Exam timetabling: one slot per course, no student in two exams at once
+QJsonObject handleExams(const QJsonObject &request)
+{
+    const QJsonArray studentArray = request["students"].toArray();
+    if (studentArray.isEmpty()) return errorReply("No students given");
+    if (studentArray.size() > MaxStudents) {
+        return errorReply(QString("At most %1 students per request").arg(MaxStudents));
+    }
+
+    QVector<QStringList> enrollments;
+    enrollments.reserve(studentArray.size());
+    for (const QJsonValue &value : studentArray) {
+        QStringList courseNames;
+        for (const QJsonValue &name : value.toArray()) courseNames.append(name.toString().trimmed());
+        enrollments.append(courseNames);
+    }
+
+    QVector<QPair<QString, QString>> extraConflicts;
+    for (const QJsonValue &value : request["conflicts"].toArray()) {
+        const QJsonArray pair = value.toArray();
+        if (pair.size() != 2) return errorReply("Each conflict is a pair of course names");
+        extraConflicts.append({ pair[0].toString().trimmed(), pair[1].toString().trimmed() });
+    }
+
+    const int slotsPerDay = qMax(1, request["slotsPerDay"].toInt(3));
+    const int budgetMs = qBound(0, request["budgetMs"].toInt(ExamBudgetMs), MaxExamBudgetMs);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ExamScheduler scheduler;
+    scheduler.setSlotsPerDay(slotsPerDay);
+    const ExamResult result = scheduler.schedule(enrollments, extraConflicts, budgetMs);
+
+    QJsonArray exams;
+    for (int i = 0; i < result.courses.size(); ++i) {
+        QJsonObject object;
+        object["course"] = result.courses[i];
+        object["slot"] = result.slots[i] + 1;
+        object["day"] = result.slots[i] / slotsPerDay + 1;
+        object["period"] = result.slots[i] % slotsPerDay + 1;
+        exams.append(object);
+    }
+
+    QJsonObject reply;
+    reply["ok"] = true;
+    reply["slots"] = result.slotCount;
+    reply["dsaturSlots"] = result.dsaturSlotCount;
+    reply["conflicts"] = result.conflicts;
+    reply["backToBackStudents"] = result.backToBackStudents;
+    reply["elapsedMs"] = timer.elapsed();
+    reply["exams"] = exams;
+    return reply;
+}
+
+} // namespace
+
+SchedulingServer::SchedulingServer(QObject *parent)
+    : QObject(parent)
+    , server(new QLocalServer(this))
+    , requestsServed(0)
+    , recentLatenciesUs(LatencySamples, -1)
+    , nextLatencySlot(0)
+    , recentFinishMs(LatencySamples, -1)
+    , nextFinishSlot(0)
+{
+    uptime.start();
+    connect(server, &QLocalServer::newConnection, this, &SchedulingServer::onNewConnection);
+}
+
+SchedulingServer::~SchedulingServer()
+{
+    pool.waitForDone();
+}
+
+bool SchedulingServer::listen(const QString &name)
+{
+    // a crashed earlier run may have left its socket file behind
+    QLocalServer::removeServer(name);
+    return server->listen(name);
+}
+
+QString SchedulingServer::errorString() const
+{
+    return server->errorString();
+}
+
+void SchedulingServer::setMaxThreads(int count)
+{
+    pool.setMaxThreadCount(qMax(1, count));
+}
+
+void SchedulingServer::onNewConnection()
+{
+    while (QLocalSocket *socket = server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+    }
+}
+
+// One request per line; every complete line is dispatched to the pool
+void SchedulingServer::onReadyRead(QLocalSocket *socket)
+{
+    while (socket->state() == QLocalSocket::ConnectedState && socket->canReadLine()) {
+        QByteArray line = socket->readLine(MaxRequestBytes + 1);
+        if (!line.endsWith('\n')) {
+            // cut off at the limit: the line goes on
+            rejectLongLine(socket);
+            return;
+        }
+
+        line = line.trimmed();
+        if (line.isEmpty()) continue;
+
+        QElapsedTimer latency;
+        latency.start();
+
+        QJsonParseError parseError;
+        const QJsonObject request = QJsonDocument::fromJson(line, &parseError).object();
+        const QJsonValue id = request["id"];
+
+        QPointer<QLocalSocket> client(socket);
+        auto reply = [this, client, id, latency](QJsonObject response) {
+            response["id"] = id;
+            recordLatency(latency.nsecsElapsed() / 1000);
+            if (client && client->state() == QLocalSocket::ConnectedState) {
+                client->write(QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n');
+            }
+        };
+
+        if (parseError.error != QJsonParseError::NoError) {
+            reply(errorReply("Request is not a JSON object"));
+        } else if (request["op"].toString() == "stats") {
+            reply(statistics());  // counters live on this thread
+        } else {
+            QtConcurrent::run(&pool, [request]() {
+                TRACE_SCOPE("worker", "server request");
+                return handleRequest(request);
+            }).then(this, reply);
+        }
+    }
+
+    // no newline within the limit: the line is too long
+    if (socket->state() == QLocalSocket::ConnectedState && socket->bytesAvailable() > MaxRequestBytes) {
+        rejectLongLine(socket);
+    }
+}
+
+QJsonObject SchedulingServer::handleRequest(const QJsonObject &request)
+{
+    const QString op = request["op"].toString();
+
+    if (op == "count") return handleCount(request);
+    if (op == "timetables") return handleTimetables(request);
+    if (op == "assignRooms") return handleAssignRooms(request);
+    if (op == "clashes") return handleClashes(request);
+    if (op == "exams") return handleExams(request);
+    return errorReply(QString("Unknown op '%1'").arg(op));
+}
+
+void SchedulingServer::recordLatency(qint64 latencyUs)
+{
+    requestsServed++;
+    recentLatenciesUs[nextLatencySlot] = latencyUs;
+    nextLatencySlot = (nextLatencySlot + 1) % LatencySamples;
+    recentFinishMs[nextFinishSlot] = uptime.elapsed();
+    nextFinishSlot = (nextFinishSlot + 1) % LatencySamples;
+}
+
+QJsonObject SchedulingServer::statistics() const
+{
+    QVector<qint64> latencies;
+    for (qint64 sample : recentLatenciesUs) {
+        if (sample >= 0) latencies.append(sample);
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentileMs = [&latencies](double p) {
+        if (latencies.isEmpty()) return 0.0;
+        const int index = qMin(int(latencies.size()) - 1, int(p * latencies.size()));
+        return latencies[index] / 1000.0;
+    };
+
+    // requests finished in the last RateWindowMs (capped by the ring size)
+    const qint64 now = uptime.elapsed();
+    int recent = 0;
+    for (qint64 finished : recentFinishMs) {
+        if (finished >= 0 && now - finished <= RateWindowMs) recent++;
+    }
+    const double window = qMin<qint64>(qMax<qint64>(now, 1), RateWindowMs) / 1000.0;
+
+    QJsonObject reply;
+    reply["ok"] = true;
+    reply["requests"] = QString::number(requestsServed);
+    reply["requestsPerSecond"] = recent / window;
+    reply["p50Ms"] = percentileMs(0.50);
+    reply["p99Ms"] = percentileMs(0.99);
+    reply["threads"] = pool.maxThreadCount();
+    reply["uptimeSeconds"] = now / 1000.0;
+    return reply;
+}
@@ -0,0 +1,92 @@
+/**
+ * SchedulingServer Header File
+ *
+ * This file defines the local server that lets other programs on the
+ * same machine request timetables without using the GUI.
+ */
+
+#ifndef SCHEDULINGSERVER_H
+#define SCHEDULINGSERVER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+#include <QThreadPool>
+#include <QElapsedTimer>
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * SchedulingServer Class
+ *
+ * Listens on a local socket (named pipe on Windows). Each request is one
+ * line of JSON, answered with one line of JSON carrying the same "id":
+ *
+ *   {"id": 1, "op": "timetables", "courses": [...], "offset": 0, "limit": 10}
+ *   {"id": 1, "ok": true, "total": 240, "timetables": [...]}
+ *
+ * Operations:
+ * - "count": number of conflict-free timetables and what constraints pruned
+ * - "timetables": timetables ranked best first (fewest idle hours and days)
+ * - "assignRooms": registrar mode, places many sections into shared rooms
+ * - "clashes": overlapping sections ranked by how many students take both
+ * - "exams": exam timetable with the fewest slots found, and back-to-back count
+ * - "stats": requests served, requests per second, p50/p99 latency
+ *
+ * "count" and "timetables" take optional "limits" ({"maxResults",
+ * "maxNodes", "deadlineMs"}; counting stops after 5 s by default) and
+ * answer with "truncated" and "estimatedTotal" next to "total".
+ *
+ * Requests are handled on a thread pool, so slow requests don't hold up
+ * other clients. handleRequest() is a pure function of its input. Each
+ * request's engine keeps at most 64 MB of memo in RAM (the rest spills to
+ * disk), and a line over 1 MB gets one error reply and a closed socket.
+ */
+class SchedulingServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SchedulingServer(QObject *parent = nullptr);
+    ~SchedulingServer();
+
+    /**
+     * Starts listening on the given local socket name
+     * @return false if the name is taken (see errorString())
+     */
+    bool listen(const QString &name);
+    QString errorString() const;
+
+    /**
+     * Maximum number of requests handled at the same time
+     */
+    void setMaxThreads(int count);
+
+    /**
+     * Answers one request (any thread)
+     */
+    static QJsonObject handleRequest(const QJsonObject &request);
+
+private slots:
+    void onNewConnection();
+
+private:
+    void onReadyRead(QLocalSocket *socket);
+    void recordLatency(qint64 latencyUs);
+    QJsonObject statistics() const;
+
+    QLocalServer *server;
+    QThreadPool pool;
+
+    // Counters, only touched on the server thread
+    QElapsedTimer uptime;
+    quint64 requestsServed;
+    QVector<qint64> recentLatenciesUs;  // Ring buffer of the latest latencies
+    int nextLatencySlot;
+    QVector<qint64> recentFinishMs;     // Ring buffer of the latest finish times (uptime ms)
+    int nextFinishSlot;
+};
+
+#endif // SCHEDULINGSERVER_H
@@ -0,0 +1,96 @@
+/**
+ * SessionManager Implementation File
+ *
+ * Implements lazy loading and LRU eviction of student sessions.
+ */
+
+#include "sessionmanager.h"
+#include "managecoursespage.h"
+
+qsizetype StudentSession::estimatedBytes() const
+{
+    // the store keeps a mirror of the list, which shares the strings
+    qsizetype bytes = 2 * courses.capacity() * qsizetype(sizeof(Course));
+    for (const Course &course : courses) {
+        bytes += (course.name.capacity() + course.day.capacity() + course.startTime.capacity() +
+                  course.endTime.capacity() + course.classroom.capacity()) * qsizetype(sizeof(QChar));
+    }
+    return bytes;
+}
+
+SessionManager::SessionManager(int maxSessions, qsizetype maxBytes)
+    : maxSessions(qMax(1, maxSessions))
+    , maxBytes(maxBytes)
+{
+}
+
+QSharedPointer<StudentSession> SessionManager::open(const QString &studentID, QString &errorMessage)
+{
+    errorMessage.clear();
+    activeStudent = studentID;
+
+    QSharedPointer<StudentSession> session = sessions.value(studentID);
+    if (session && session->store.isOpen()) {
+        touch(studentID);
+        return session;
+    }
+
+    // First login (or evicted since): replay the journal
+    session = QSharedPointer<StudentSession>::create();
+    session->studentID = studentID;
+    if (!session->store.open(studentID, session->courses)) {
+        errorMessage = session->store.errorString();
+    }
+
+    sessions.insert(studentID, session);
+    touch(studentID);
+    evict();
+    return session;
+}
+
+void SessionManager::release(const QString &studentID)
+{
+    if (activeStudent == studentID) {
+        activeStudent.clear();
+    }
+    evict();
+}
+
+int SessionManager::sessionCount() const
+{
+    return sessions.size();
+}
+
+qsizetype SessionManager::memoryUse() const
+{
+    qsizetype bytes = 0;
+    for (const QSharedPointer<StudentSession> &session : sessions) {
+        bytes += session->estimatedBytes();
+    }
+    return bytes;
+}
+
+void SessionManager::touch(const QString &studentID)
+{
+    recentlyUsed.removeOne(studentID);
+    recentlyUsed.append(studentID);
+}
+
+// Drops least recently used sessions until both limits hold
+void SessionManager::evict()
+{
+    qsizetype bytes = memoryUse();
+
+    for (int i = 0; i < recentlyUsed.size() &&
+                    (sessions.size() > maxSessions || bytes > maxBytes);) {
+        const QString studentID = recentlyUsed[i];
+        if (studentID == activeStudent) {
+            ++i;
+            continue;
+        }
+
+        bytes -= sessions.value(studentID)->estimatedBytes();
+        sessions.remove(studentID);  // closes the journal
+        recentlyUsed.removeAt(i);
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ * SessionManager Header File
+ *
+ * This file defines the per-student sessions that let one running
+ * instance serve many students in turn (e.g. on a lab kiosk).
+ */
+
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+#include <QSharedPointer>
+#include "coursestore.h"
+
+struct Course;  // Forward declaration
+
+/**
+ * Student Session
+ *
+ * Everything that belongs to one student: the course list and the
+ * journal it is saved to. Nothing is shared between sessions.
+ */
+struct StudentSession {
+    QString studentID;
+    QVector<Course> courses;
+    CourseStore store;
+
+    /**
+     * Rough heap size of the course list (used for eviction)
+     */
+    qsizetype estimatedBytes() const;
+};
+
+/**
+ * SessionManager Class
+ *
+ * Sessions are loaded lazily: the first login of a student replays their
+ * journal, later logins reuse the session if it is still in memory.
+ *
+ * After logout a session is kept for a quick return, but the least
+ * recently used sessions are evicted once there are too many or they
+ * use too much memory. Every change is already on disk (CourseStore),
+ * so eviction only frees memory and closes the journal file. The
+ * session of the logged-in student is never evicted.
+ */
+class SessionManager {
+public:
+    /**
+     * @param maxSessions: Sessions kept in memory at most
+     * @param maxBytes: Estimated memory the kept sessions may use
+     */
+    explicit SessionManager(int maxSessions = 32, qsizetype maxBytes = 8 * 1024 * 1024);
+
+    /**
+     * Starts a student's session, loading it if it is not in memory
+     * @param errorMessage: Set if the saved courses could not be loaded
+     *        (the session is still returned, but changes cannot be saved)
+     */
+    QSharedPointer<StudentSession> open(const QString &studentID, QString &errorMessage);
+
+    /**
+     * Ends the active session (logout); it may be evicted from now on
+     */
+    void release(const QString &studentID);
+
+    int sessionCount() const;
+    qsizetype memoryUse() const;
+
+private:
+    void touch(const QString &studentID);
+    void evict();
+
+    QHash<QString, QSharedPointer<StudentSession>> sessions;
+    QList<QString> recentlyUsed;  // Least recently used first
+    QString activeStudent;        // Logged-in student, never evicted
+    int maxSessions;
+    qsizetype maxBytes;
+};
+
+#endif // SESSIONMANAGER_H
@@ -20,6 +20,9 @@ SignupWindow::SignupWindow(QWidget *parent)
     // Set up the user interface from Qt Designer
     ui->setupUi(this);
 
+    // Busy bar is only shown while an account is being created
+    ui->progressBar_Busy->hide();
+
     /**
      * Connect button signals to slots
      * These connections handle button click events
@@ -91,6 +94,17 @@ void SignupWindow::on_pushButton_Confirm_clicked()
         return;
     }
 
+    /**
+     * Lock the Form
+     *
+     * The password is hashed in the background, which takes a moment.
+     * The dialog stays open (but locked) until registrationFinished()
+     * is called with the result. This must happen before the emit:
+     * MainWindow may reject the ID straight away and call
+     * registrationFinished() from inside it.
+     */
+    setBusy(true);
+
     /**
      * Emit Signal to MainWindow
      *
@@ -102,19 +116,46 @@ void SignupWindow::on_pushButton_Confirm_clicked()
      * the parent window (MainWindow).
      */
     emit userRegistered(studentID, password);
+}
 
-    // Clear all input fields for security and to prepare for next use
-    ui->lineEdit_StudentID->clear();
-    ui->lineEdit_Password->clear();
-    ui->lineEdit_ConfirmPassword_2->clear();
+/**
+ * Registration Finished
+ *
+ * Closes the dialog after a successful registration, or unlocks the
+ * form so the user can correct the input.
+ */
+void SignupWindow::registrationFinished(bool success)
+{
+    setBusy(false);
 
-    /**
-     * Close the Dialog with Success Status
-     *
-     * accept() closes the dialog and returns QDialog::Accepted
-     * This is the standard way to close a dialog after successful operation
-     */
-    this->accept();
+    if (success) {
+        ui->lineEdit_StudentID->clear();
+        ui->lineEdit_Password->clear();
+        ui->lineEdit_ConfirmPassword_2->clear();
+
+        /**
+         * Close the Dialog with Success Status
+         *
+         * accept() closes the dialog and returns QDialog::Accepted
+         * This is the standard way to close a dialog after successful operation
+         */
+        this->accept();
+    }
+}
+
+/**
+ * Set Busy
+ *
+ * Locks the inputs and shows the busy bar while waiting for MainWindow.
+ */
+void SignupWindow::setBusy(bool busy)
+{
+    ui->lineEdit_StudentID->setEnabled(!busy);
+    ui->lineEdit_Password->setEnabled(!busy);
+    ui->lineEdit_ConfirmPassword_2->setEnabled(!busy);
+    ui->pushButton_Confirm->setEnabled(!busy);
+    ui->pushButton_Back->setEnabled(!busy);
+    ui->progressBar_Busy->setVisible(busy);
 }
 
 /**
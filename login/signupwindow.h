@@ -24,6 +24,7 @@ class SignupWindow;
  * - Input fields for student ID, password, and password confirmation
  * - Password matching validation
  * - Signal emission to notify MainWindow of successful registration
+ * - Busy indicator while MainWindow hashes the password in the background
  * - Modal behavior (blocks interaction with parent window)
  */
 class SignupWindow : public QDialog
@@ -42,6 +43,14 @@ public:
      */
     ~SignupWindow();
 
+    /**
+     * Called by MainWindow when the account has been saved (or not)
+     * On success the form is cleared and the dialog closes; on failure
+     * the dialog stays open so the user can try another ID
+     * @param success: true if the account was created
+     */
+    void registrationFinished(bool success);
+
 signals:
     /**
      * Signal emitted when a user successfully completes registration
@@ -71,6 +80,11 @@ private slots:
     void on_pushButton_Back_clicked();
 
 private:
+    /**
+     * Shows the busy bar and locks the form while the account is created
+     */
+    void setBusy(bool busy);
+
     Ui::SignupWindow *ui;  // Pointer to UI components from Qt Designer
 };
 
@@ -1,17 +1,70 @@
 #include "timetable.h"
 #include "ui_timetable.h"
 #include "managecoursespage.h"
+#include "timetablerenderer.h"
+#include "timetableexporter.h"
+#include "timetablecomparedialog.h"
+#include "generationcache.h"
+#include "perfmetrics.h"
+#include "tracer.h"
+#include "allocstats.h"
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QPainter>
-#include <QPixmap>
-#include <QTableWidgetItem>
-#include <QColor>
+#include <QLocale>
+#include <QStringList>
+#include <QTimer>
+#include <limits>
+#include <QFutureWatcher>
+#include <QInputDialog>
+#include <QProgressDialog>
+#include <QtConcurrent/QtConcurrentRun>
+#ifdef TIMETABLE_METRICS
+#include <QLabel>
+#include <QShortcut>
+#endif
+
+namespace {
+
+// Optimizer time budgets: a short first pass when the window opens, then
+// small slices on a timer so the window stays responsive
+const int OptimizerFirstPassMs = 50;
+const int OptimizerSliceMs = 20;
+const int OptimizerIntervalMs = 200;
+
+// Rendered pages kept for instant paging, in KB (about 20 full-screen pages)
+const int PageCacheKB = 48 * 1024;
+
+// Neighbouring pages are rendered once paging has paused for this long
+const int PrerenderDelayMs = 60;
+
+// Counting stops after this long or this many states, so Generate always
+// returns quickly; the pages counted so far can still be browsed
+const qint64 GenerationDeadlineMs = 2000;
+const quint64 GenerationMaxNodes = 50000000;
+
+// Bigger memos are not saved with a result (about 24 MB each)
+const int MaxSavedMemoEntries = 1 << 20;
+
+// Resolution of saved images (96 = screen size, 192 = twice as sharp)
+const qreal ExportDpi = 192.0;
+
+#ifdef TIMETABLE_METRICS
+const int MetricsRefreshMs = 500;
+#endif
+
+} // namespace
 
 TIMETABLE::TIMETABLE(QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::TIMETABLE)
+    , combinationCount(0)
     , currentCombinationIndex(0)
+    , currentVariantCount(1)
+    , pageCache(PageCacheKB)
+    , prerenderTimer(new QTimer(this))
+    , optimizerTimer(new QTimer(this))
+    , generationCache(nullptr)
+    , exportProgress(nullptr)
 {
     ui->setupUi(this);
 
@@ -27,48 +80,97 @@ TIMETABLE::TIMETABLE(QWidget *parent)
     connect(ui->prevPageBtn, &QPushButton::clicked, this, &TIMETABLE::onPrevPage);
     connect(ui->nextPageBtn, &QPushButton::clicked, this, &TIMETABLE::onNextPage);
     connect(ui->deleteBtn, &QPushButton::clicked, this, &TIMETABLE::onDelete);
-
-    // Initialize timetable table
-    if (ui->timetableTable) {
-        ui->timetableTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-
-        // Configure column sizing - stretch to fill window
-        ui->timetableTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-        ui->timetableTable->horizontalHeader()->setStretchLastSection(true);
-        ui->timetableTable->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-
-        // Enable vertical scrolling to see all 7 days
-        ui->timetableTable->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-
-        // Set row height - increased for better text display
-        for (int row = 0; row < ui->timetableTable->rowCount(); ++row) {
-            ui->timetableTable->setRowHeight(row, 80);
-        }
-
-        // Enable word wrapping to show all text
-        ui->timetableTable->setWordWrap(true);
-        ui->timetableTable->setTextElideMode(Qt::ElideNone);
-    }
+    connect(ui->pageJumpInput, &QLineEdit::returnPressed, this, &TIMETABLE::onJumpToPage);
+    connect(ui->bestBtn, &QPushButton::clicked, this, &TIMETABLE::onShowBest);
+    connect(ui->exportAllBtn, &QPushButton::clicked, this, &TIMETABLE::onExportAll);
+    connect(ui->compareBtn, &QPushButton::clicked, this, &TIMETABLE::onCompare);
+    connect(optimizerTimer, &QTimer::timeout, this, &TIMETABLE::onOptimizerTick);
+
+    prerenderTimer->setSingleShot(true);
+    prerenderTimer->setInterval(PrerenderDelayMs);
+    connect(prerenderTimer, &QTimer::timeout, this, &TIMETABLE::onPrerenderTick);
+
+#ifdef TIMETABLE_METRICS
+    metricsOverlay = new QLabel(ui->timetableGrid);
+    metricsOverlay->setStyleSheet("QLabel{background-color: rgba(0, 0, 0, 190); color: #7CFC00; font-family: monospace; font-size: 11px; padding: 6px;}");
+    metricsOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+    metricsOverlay->hide();
+
+    metricsTimer = new QTimer(this);
+    metricsTimer->setInterval(MetricsRefreshMs);
+    connect(metricsTimer, &QTimer::timeout, this, &TIMETABLE::refreshMetricsOverlay);
+
+    QShortcut *metricsShortcut = new QShortcut(QKeySequence("Ctrl+Shift+M"), this);
+    connect(metricsShortcut, &QShortcut::activated, this, &TIMETABLE::toggleMetricsOverlay);
+#endif
 }
 
 TIMETABLE::~TIMETABLE()
 {
+    // keep whatever paging and the optimizer added since the last save
+    storeGenerationResult();
+
+    // a running export finishes its current batch and then deletes itself
+    if (exporter) {
+        exporter->cancel();
+    }
     delete ui;
 }
 
 // This gets called when user clicks "Generate Timetable" button
 // Main job: take the courses and display them on the timetable
-void TIMETABLE::setCoursesData(const QVector<Course> &courses)
+void TIMETABLE::setCoursesData(const QVector<Course> &courses,
+                               const ScheduleConstraints &constraints)
 {
+    METRICS_SCOPE(Metric::Generate);
+    TRACE_SCOPE("engine", "generate");
+    ALLOC_SCOPE(AllocOperation::Generate);
+
     coursesData = courses;  // store the courses locally
-    allCombinations.clear();  // clear any old combinations
     currentCombinationIndex = 0;  // start from first page
+    pageCache.clear();  // pages of the old course list
+
+    // Count the non-conflicting combinations without generating them
+    // (locked/excluded sections and the time window are filtered out first)
+    engine.setCourses(coursesData, constraints);
+    GenerationLimits limits;
+    limits.maxNodes = GenerationMaxNodes;
+    limits.deadlineMs = GenerationDeadlineMs;
+    engine.setLimits(limits);
+
+    // Same courses as before (this session or an earlier one): start from
+    // the saved counts, so counting is a single memo lookup
+    GenerationResult cached;
+    bool reused = false;
+    if (generationCache) {
+        generationKey = GenerationCache::keyFor(coursesData, constraints);
+        reused = generationCache->lookup(generationKey, cached);
+        if (reused && !cached.engineMemo.isEmpty()) {
+            engine.restoreMemo(cached.engineMemo);
+        }
+    }
 
-    // Generate all possible non-conflicting combinations
-    generateAllCombinations();
+    {
+        METRICS_SCOPE(Metric::EngineCount);
+        TRACE_SCOPE("engine", "count");
+        combinationCount = engine.validCount();
+    }
+    updateConstraintsLabel();
+
+    // Start the optimizer: a quick first answer now, improved in the background
+    optimizer.setProblem(engine);
+    if (reused) {
+        optimizer.resumeFrom(cached.bestChoices, cached.optimizerSettled);
+    }
+    optimizer.run(OptimizerFirstPassMs);
+    updateBestButton();
+    if (!optimizer.isSettled()) {
+        optimizerTimer->start(OptimizerIntervalMs);
+    }
+    storeGenerationResult();
 
     // Display the first combination if any exist
-    if (!allCombinations.isEmpty()) {
+    if (combinationCount > 0) {
         displayCurrentCombination();
         updatePageLabel();
     } else {
@@ -79,77 +181,77 @@ void TIMETABLE::setCoursesData(const QVector<Course> &courses)
     }
 }
 
+// The grid widget paints the whole page itself - no per-cell items,
+// and no spans left over from the previous page
 void TIMETABLE::populateTimetable()
 {
-    if (!ui->timetableTable) return;
-
-    // Clear existing content
-    ui->timetableTable->clearContents();
-
-    // Use single default deep blue color for all courses
-    QColor defaultColor("#2d5a8c");
-
-    // Process each course and create spanning cells
-    for (const Course &course : coursesData) {
-        int row = dayToRow(course.day);
-        int startCol = timeToColumn(course.startTime);
-        int endCol = timeToColumn(course.endTime);
-
-        if (row < 0 || startCol < 0 || endCol < 0) continue;
-        if (startCol >= endCol) continue; // Invalid time range
-
-        // Calculate span duration
-        int colSpan = endCol - startCol;
-
-        // Create the main cell with full course information - compact format
-        QTableWidgetItem *mainItem = new QTableWidgetItem(
-            QString("%1\n%2\n%3-%4")
-                .arg(course.name)
-                .arg(course.classroom)
-                .arg(course.startTime)
-                .arg(course.endTime)
-        );
-
-        mainItem->setBackground(QBrush(defaultColor));
-        mainItem->setForeground(QBrush(QColor("#FFFFFF")));
-        mainItem->setTextAlignment(Qt::AlignCenter | Qt::AlignVCenter);
-
-        // Enable word wrapping for this specific item
-        mainItem->setData(Qt::TextWordWrap, true);
+    if (!ui->timetableGrid) return;
+    METRICS_SCOPE(Metric::PopulateTimetable);
+    TRACE_SCOPE("ui", "populateTimetable");
 
-        // Smaller font size to fit more content
-        QFont font = mainItem->font();
-        font.setBold(true);
-        font.setPointSize(8);  // Reduced from 10 to 8
-        mainItem->setFont(font);
-
-        // Set the item at the starting position
-        ui->timetableTable->setItem(row, startCol, mainItem);
-
-        // If course spans multiple hours, merge cells
-        if (colSpan > 1) {
-            ui->timetableTable->setSpan(row, startCol, 1, colSpan);
-        }
-    }
+    ui->timetableGrid->setCourses(coursesData);
 }
 
 void TIMETABLE::updateStatistics()
 {
     if (!ui->totalCourseLabel || !ui->totalHoursLabel || !ui->conflictsLabel) return;
+    METRICS_SCOPE(Metric::UpdateStatistics);
+    TRACE_SCOPE("ui", "updateStatistics");
+
+    showStatistics(coursesData.size(), calculateTotalHours(coursesData), detectConflicts(coursesData));
+}
 
-    int totalCourses = coursesData.size();
-    int totalHours = calculateTotalHours();
-    int conflicts = detectConflicts();
+void TIMETABLE::showStatistics(int totalCourses, int totalHours, int conflicts)
+{
+    if (!ui->totalCourseLabel || !ui->totalHoursLabel || !ui->conflictsLabel) return;
 
     ui->totalCourseLabel->setText(QString("Total Course: %1").arg(totalCourses));
     ui->totalHoursLabel->setText(QString("Total Hours: %1").arg(totalHours));
     ui->conflictsLabel->setText(QString("Conflicts: %1").arg(conflicts));
 }
 
-int TIMETABLE::calculateTotalHours()
+// Shows how much each constraint cut from the search space
+void TIMETABLE::updateConstraintsLabel()
+{
+    if (!ui->constraintsLabel) return;
+
+    const PruneReport &report = engine.pruneReport();
+    int pruned = report.excludedSections + report.lockedOutSections + report.outsideTimeWindow;
+
+    QLocale locale;
+    QStringList lines;
+    if (pruned > 0) {
+        lines.append(QString("Constraints removed %1 section(s): %2 excluded, %3 locked out, %4 outside hours\n"
+                             "Search space: %5 -> %6")
+                         .arg(pruned)
+                         .arg(report.excludedSections)
+                         .arg(report.lockedOutSections)
+                         .arg(report.outsideTimeWindow)
+                         .arg(locale.toString(report.searchSpaceBefore))
+                         .arg(locale.toString(report.searchSpaceAfter)));
+        if (report.emptyGroups > 0) {
+            lines.append(QString("%1 course(s) have no section left!").arg(report.emptyGroups));
+        }
+    }
+
+    // Counting hit a limit: say how much is shown out of roughly how many
+    if (engine.isTruncated()) {
+        lines.append(QString("Too many timetables to count: showing %1 of about %2")
+                         .arg(locale.toString(engine.validCount()))
+                         .arg(locale.toString(engine.estimatedTotal())));
+    }
+
+    if (lines.isEmpty()) {
+        ui->constraintsLabel->clear();
+        return;
+    }
+    ui->constraintsLabel->setText(lines.join('\n'));
+}
+
+int TIMETABLE::calculateTotalHours(const QVector<Course> &courses)
 {
     int total = 0;
-    for (const Course &course : coursesData) {
+    for (const Course &course : courses) {
         int start = timeToColumn(course.startTime);
         int end = timeToColumn(course.endTime);
         if (start >= 0 && end >= 0) {
@@ -159,15 +261,16 @@ int TIMETABLE::calculateTotalHours()
     return total;
 }
 
-int TIMETABLE::detectConflicts()
+int TIMETABLE::detectConflicts(const QVector<Course> &courses)
 {
+    METRICS_SCOPE(Metric::DetectConflicts);
     int conflicts = 0;
 
     // Check every pair of courses for time conflicts
-    for (int i = 0; i < coursesData.size(); ++i) {
-        for (int j = i + 1; j < coursesData.size(); ++j) {
-            const Course &course1 = coursesData[i];
-            const Course &course2 = coursesData[j];
+    for (int i = 0; i < courses.size(); ++i) {
+        for (int j = i + 1; j < courses.size(); ++j) {
+            const Course &course1 = courses[i];
+            const Course &course2 = courses[j];
 
             // Only check courses on the same day
             if (course1.day != course2.day) {
@@ -195,120 +298,177 @@ int TIMETABLE::detectConflicts()
 }
 
 // converts time string (like "8am", "2pm") into column number for the table
-// basically maps time to table column position
+// 8am = column 0, 9am = column 1, etc; -1 if the time is out of range
 int TIMETABLE::timeToColumn(const QString &time)
 {
-    QString t = time.toLower().trimmed();
-
-    int hour = 0;
-    bool isPM = t.contains("pm");
-
-    // clean up the string - remove am/pm and .00
-    QString numStr = t;
-    numStr.remove("am").remove("pm").remove(".00");
-    hour = numStr.toInt();
-
-    // handle 12 hour to 24 hour conversion
-    if (isPM && hour != 12) {
-        hour += 12;  // 2pm becomes 14
-    } else if (!isPM && hour == 12) {
-        hour = 0;  // 12am is actually 0 (midnight)
-    }
-
-    // our timetable starts at 8am, so 8am = column 0, 9am = column 1, etc
-    if (hour >= 8 && hour <= 21) {
-        return hour - 8;
-    }
-
-    return -1; // something went wrong, time not in range
+    return TimetableEngine::hourIndex(time);
 }
 
 int TIMETABLE::dayToRow(const QString &day)
 {
-    QMap<QString, int> dayMap;
-    dayMap["Monday"] = 0;
-    dayMap["Tuesday"] = 1;
-    dayMap["Wednesday"] = 2;
-    dayMap["Thursday"] = 3;
-    dayMap["Friday"] = 4;
-    dayMap["Saturday"] = 5;
-    dayMap["Sunday"] = 6;
-
-    return dayMap.value(day, -1);
+    return TimetableEngine::dayIndex(day);
 }
 
 void TIMETABLE::onSaveAs()
 {
-    if (!ui->timetableTable) {
-        QMessageBox::warning(this, "Error", "Timetable table not found!");
-        return;
-    }
-
     // Open file dialog to choose save location
     QString fileName = QFileDialog::getSaveFileName(
         this,
         "Save Timetable As",
         QDir::homePath() + "/timetable.png",
-        "PNG Image (*.png);;JPEG Image (*.jpg);;All Files (*.*)"
+        "PNG Image (*.png);;JPEG Image (*.jpg);;PDF Document (*.pdf);;SVG Image (*.svg);;All Files (*.*)"
     );
 
     if (fileName.isEmpty()) {
         return; // User cancelled
     }
 
-    // Save original geometry and policies
-    QSize originalSize = ui->timetableTable->size();
-    Qt::ScrollBarPolicy oldHPolicy = ui->timetableTable->horizontalScrollBarPolicy();
-    Qt::ScrollBarPolicy oldVPolicy = ui->timetableTable->verticalScrollBarPolicy();
-
-    // Temporarily disable scrollbars
-    ui->timetableTable->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    ui->timetableTable->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-
-    // Calculate exact size needed for all content (all 7 days)
-    int totalWidth = ui->timetableTable->verticalHeader()->width();
-    for (int col = 0; col < ui->timetableTable->columnCount(); ++col) {
-        totalWidth += ui->timetableTable->columnWidth(col);
-    }
+    // PDF and SVG are drawn as vectors, everything else as a raster image
+    // Draw the page straight from the course data on a worker thread -
+    // the on-screen table is never resized or re-laid out
+    QVector<Course> pageCourses = currentPageCourses();
+    setSavingInProgress(true);
+
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher]() {
+        bool saved = watcher->result();
+        watcher->deleteLater();
+        setSavingInProgress(false);
+
+        // Report the result once the file is written
+        if (saved) {
+            QMessageBox msgBox(this);
+            msgBox.setWindowTitle("Success");
+            msgBox.setText("Full timetable (Monday to Sunday) saved successfully!");
+            msgBox.setIcon(QMessageBox::Information);
+            msgBox.setStyleSheet("QMessageBox{background-color: #ffffff;} QLabel{color: #000000; font-size: 11px; background-color: transparent;} QPushButton{background-color: #e0e0e0; color: #000000; font-size: 11px; min-width: 60px; padding: 5px;}");
+            msgBox.exec();
+        } else {
+            QMessageBox msgBox(this);
+            msgBox.setWindowTitle("Error");
+            msgBox.setText("Failed to save timetable!");
+            msgBox.setIcon(QMessageBox::Warning);
+            msgBox.setStyleSheet("QMessageBox{background-color: #ffffff;} QLabel{color: #000000; font-size: 11px; background-color: transparent;} QPushButton{background-color: #e0e0e0; color: #000000; font-size: 11px; min-width: 60px; padding: 5px;}");
+            msgBox.exec();
+        }
+    });
+
+    watcher->setFuture(QtConcurrent::run([pageCourses, fileName]() {
+        METRICS_SCOPE(Metric::SaveAs);
+        TRACE_SCOPE("worker", "save as");
+        ALLOC_SCOPE(AllocOperation::SaveImage);
+        if (fileName.endsWith(".pdf", Qt::CaseInsensitive)) {
+            return TimetableRenderer::writePdf(pageCourses, fileName);
+        }
+        if (fileName.endsWith(".svg", Qt::CaseInsensitive)) {
+            return TimetableRenderer::writeSvg(pageCourses, fileName);
+        }
+        QImage image = TimetableRenderer::renderImage(pageCourses, ExportDpi);
+        return image.save(fileName);
+    }));
+}
 
-    int totalHeight = ui->timetableTable->horizontalHeader()->height();
-    for (int row = 0; row < ui->timetableTable->rowCount(); ++row) {
-        totalHeight += ui->timetableTable->rowHeight(row);
-    }
+// Exports many pages in one pass on a worker thread: one multi-page PDF,
+// or one numbered image per page. Progress is shown and can be cancelled.
+void TIMETABLE::onExportAll()
+{
+    if (combinationCount == 0 || exporter) return;
 
-    // Temporarily resize table to fit all content
-    ui->timetableTable->resize(totalWidth, totalHeight);
+    // Ask how many pages to export, starting from page 1 (all by default)
+    const int maxPages = int(qMin<quint64>(combinationCount, std::numeric_limits<int>::max()));
+    bool ok = false;
+    int pages = QInputDialog::getInt(this, "Export All Pages",
+                                     QString("Number of pages to export (1 - %1):").arg(maxPages),
+                                     maxPages, 1, maxPages, 1, &ok);
+    if (!ok) return;
 
-    // Create pixmap with exact table size
-    QPixmap pixmap(totalWidth, totalHeight);
-    pixmap.fill(QColor("#0D1B2A"));  // Use table background color
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        "Export Timetables As",
+        QDir::homePath() + "/timetables.pdf",
+        "PDF Document (*.pdf);;PNG Images, one per page (*.png);;JPEG Images, one per page (*.jpg)"
+    );
 
-    // Render only the table content
-    QPainter painter(&pixmap);
-    ui->timetableTable->render(&painter, QPoint(), QRegion(), QWidget::DrawChildren);
-    painter.end();
+    if (fileName.isEmpty()) {
+        return; // User cancelled
+    }
 
-    // Restore original size and scrollbar policies
-    ui->timetableTable->resize(originalSize);
-    ui->timetableTable->setHorizontalScrollBarPolicy(oldHPolicy);
-    ui->timetableTable->setVerticalScrollBarPolicy(oldVPolicy);
+    engine.spillToDisk();  // the exporter's copy reads the counts from the shared file
+    exporter = new TimetableExporter(engine, quint64(pages), fileName, ExportDpi);
+
+    exportProgress = new QProgressDialog("Exporting timetables...", "Cancel", 0, pages, this);
+    exportProgress->setWindowTitle("Export All Pages");
+    exportProgress->setWindowModality(Qt::WindowModal);
+    exportProgress->setMinimumDuration(0);
+    exportProgress->setValue(0);
+
+    connect(exportProgress, &QProgressDialog::canceled, exporter.data(), &TimetableExporter::cancel);
+    connect(exporter.data(), &TimetableExporter::progress, this, [this](quint64 pagesDone, quint64) {
+        if (exportProgress) exportProgress->setValue(int(pagesDone));
+    });
+    connect(exporter.data(), &TimetableExporter::finished, this,
+            [this](bool success, quint64 pagesWritten, const QString &errorMessage) {
+        if (exportProgress) {
+            exportProgress->deleteLater();
+            exportProgress = nullptr;
+        }
 
-    // Save the pixmap to file
-    if (pixmap.save(fileName)) {
         QMessageBox msgBox(this);
-        msgBox.setWindowTitle("Success");
-        msgBox.setText("Full timetable (Monday to Sunday) saved successfully!");
-        msgBox.setIcon(QMessageBox::Information);
-        msgBox.setStyleSheet("QMessageBox{background-color: #ffffff;} QLabel{color: #000000; font-size: 11px; background-color: transparent;} QPushButton{background-color: #e0e0e0; color: #000000; font-size: 11px; min-width: 60px; padding: 5px;}");
-        msgBox.exec();
-    } else {
-        QMessageBox msgBox(this);
-        msgBox.setWindowTitle("Error");
-        msgBox.setText("Failed to save timetable!");
-        msgBox.setIcon(QMessageBox::Warning);
+        if (success) {
+            msgBox.setWindowTitle("Success");
+            msgBox.setText(QString("%1 timetable page(s) exported successfully!")
+                           .arg(QLocale().toString(pagesWritten)));
+            msgBox.setIcon(QMessageBox::Information);
+        } else {
+            msgBox.setWindowTitle(errorMessage.isEmpty() ? "Export Cancelled" : "Error");
+            msgBox.setText(errorMessage.isEmpty()
+                               ? QString("Export cancelled after %1 page(s).").arg(pagesWritten)
+                               : QString("Failed to export timetables!\n\n%1").arg(errorMessage));
+            msgBox.setIcon(errorMessage.isEmpty() ? QMessageBox::Information : QMessageBox::Warning);
+        }
         msgBox.setStyleSheet("QMessageBox{background-color: #ffffff;} QLabel{color: #000000; font-size: 11px; background-color: transparent;} QPushButton{background-color: #e0e0e0; color: #000000; font-size: 11px; min-width: 60px; padding: 5px;}");
         msgBox.exec();
+    });
+
+    exporter->start();
+}
+
+// Opens the thumbnail view on the current page; clicking a thumbnail
+// comes back here and shows that page
+void TIMETABLE::onCompare()
+{
+    if (combinationCount <= 1 || compareDialog) return;
+
+    compareDialog = new TimetableCompareDialog(&engine, combinationCount, this);
+    compareDialog->setAttribute(Qt::WA_DeleteOnClose);
+    compareDialog->setWindowModality(Qt::WindowModal);  // the engine must not change underneath it
+
+    connect(compareDialog.data(), &TimetableCompareDialog::pageSelected, this, [this](quint64 page) {
+        if (page >= combinationCount) return;
+        currentCombinationIndex = page;
+        displayCurrentCombination();
+        updatePageLabel();
+    });
+
+    compareDialog->showPage(currentCombinationIndex);
+    compareDialog->show();
+}
+
+// Disables Save As while an export is still running
+void TIMETABLE::setSavingInProgress(bool busy)
+{
+    if (!ui->saveAsBtn) return;
+    ui->saveAsBtn->setEnabled(!busy);
+    ui->saveAsBtn->setText(busy ? "Saving..." : "Save as");
+}
+
+// Courses shown on the current page (all courses if there are no pages)
+QVector<Course> TIMETABLE::currentPageCourses()
+{
+    if (currentCombinationIndex < combinationCount) {
+        return engine.combinationAt(currentCombinationIndex);
     }
+    return coursesData;
 }
 
 void TIMETABLE::onBack()
@@ -318,11 +478,12 @@ void TIMETABLE::onBack()
 
 void TIMETABLE::onPrevPage()
 {
-    if (allCombinations.isEmpty()) return;
+    if (combinationCount == 0) return;
 
-    currentCombinationIndex--;
-    if (currentCombinationIndex < 0) {
-        currentCombinationIndex = allCombinations.size() - 1;  // Wrap to last
+    if (currentCombinationIndex == 0) {
+        currentCombinationIndex = combinationCount - 1;  // Wrap to last
+    } else {
+        currentCombinationIndex--;
     }
 
     displayCurrentCombination();
@@ -331,10 +492,10 @@ void TIMETABLE::onPrevPage()
 
 void TIMETABLE::onNextPage()
 {
-    if (allCombinations.isEmpty()) return;
+    if (combinationCount == 0) return;
 
     currentCombinationIndex++;
-    if (currentCombinationIndex >= allCombinations.size()) {
+    if (currentCombinationIndex >= combinationCount) {
         currentCombinationIndex = 0;  // Wrap to first
     }
 
@@ -344,11 +505,11 @@ void TIMETABLE::onNextPage()
 
 void TIMETABLE::onTogglePage()
 {
-    if (allCombinations.isEmpty() || allCombinations.size() <= 1) return;
+    if (combinationCount <= 1) return;
 
     // Toggle between pages
     currentCombinationIndex++;
-    if (currentCombinationIndex >= allCombinations.size()) {
+    if (currentCombinationIndex >= combinationCount) {
         currentCombinationIndex = 0;  // Wrap back to first
     }
 
@@ -356,6 +517,123 @@ void TIMETABLE::onTogglePage()
     updatePageLabel();
 }
 
+// Pages are unranked directly by the engine, so jumping to page 500,000
+// costs the same as stepping to the next page
+void TIMETABLE::onJumpToPage()
+{
+    if (!ui->pageJumpInput || combinationCount == 0) return;
+
+    // accept "500000" as well as "500,000"
+    QString text = ui->pageJumpInput->text().trimmed();
+    text.remove(',').remove(' ');
+
+    bool ok = false;
+    quint64 page = text.toULongLong(&ok);
+
+    if (!ok || page < 1 || page > combinationCount) {
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle("Invalid Page");
+        msgBox.setText(QString("Please enter a page between 1 and %1!")
+                       .arg(QLocale().toString(combinationCount)));
+        msgBox.setIcon(QMessageBox::Warning);
+        msgBox.setStyleSheet("QMessageBox{background-color: #ffffff;} QLabel{color: #000000; font-size: 11px; background-color: transparent;} QPushButton{background-color: #e0e0e0; color: #000000; font-size: 11px; min-width: 60px; padding: 5px;}");
+        msgBox.exec();
+        ui->pageJumpInput->selectAll();
+        return;
+    }
+
+    currentCombinationIndex = page - 1;
+    ui->pageJumpInput->clear();
+
+    displayCurrentCombination();
+    updatePageLabel();
+}
+
+// Shows the optimizer's best conflict-free timetable. It is also a page of
+// the normal list, so its page number is found by ranking its choices.
+void TIMETABLE::onShowBest()
+{
+    if (!optimizer.hasConflictFreeResult()) {
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle("No Timetable Yet");
+        msgBox.setText("No conflict-free timetable has been found yet!");
+        msgBox.setIcon(QMessageBox::Information);
+        msgBox.setStyleSheet("QMessageBox{background-color: #ffffff;} QLabel{color: #000000; font-size: 11px; background-color: transparent;} QPushButton{background-color: #e0e0e0; color: #000000; font-size: 11px; min-width: 60px; padding: 5px;}");
+        msgBox.exec();
+        return;
+    }
+
+    // when counting stopped early the best timetable may not be on any page
+    quint64 page = engine.rankOf(optimizer.bestChoices());
+    if (page >= combinationCount || engine.choicesAt(page) != optimizer.bestChoices()) {
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle("Not Listed");
+        msgBox.setText("The best timetable found is not among the pages counted so far!");
+        msgBox.setIcon(QMessageBox::Information);
+        msgBox.setStyleSheet("QMessageBox{background-color: #ffffff;} QLabel{color: #000000; font-size: 11px; background-color: transparent;} QPushButton{background-color: #e0e0e0; color: #000000; font-size: 11px; min-width: 60px; padding: 5px;}");
+        msgBox.exec();
+        return;
+    }
+
+    currentCombinationIndex = page;
+    displayCurrentCombination();
+    updatePageLabel();
+}
+
+void TIMETABLE::onOptimizerTick()
+{
+    // stop once the window is closed or the search has settled
+    if (!isVisible() || optimizer.isSettled()) {
+        optimizerTimer->stop();
+        storeGenerationResult();
+        return;
+    }
+
+    optimizer.run(OptimizerSliceMs);
+    updateBestButton();
+}
+
+void TIMETABLE::setGenerationCache(GenerationCache *cache)
+{
+    generationCache = cache;
+}
+
+// Saves the count, the memo built so far and the optimizer's best answer
+// under the current course set's key
+void TIMETABLE::storeGenerationResult()
+{
+    if (!generationCache || generationKey.isEmpty()) return;
+
+    GenerationResult result;
+    result.validCount = combinationCount;
+    if (engine.memoSize() <= MaxSavedMemoEntries) {
+        result.engineMemo = engine.saveMemo();
+    }
+    if (optimizer.hasResult()) {
+        result.bestChoices = optimizer.bestChoices();
+        result.optimizerSettled = optimizer.isSettled();
+    }
+
+    generationCache->store(generationKey, result);
+}
+
+void TIMETABLE::updateBestButton()
+{
+    if (!ui->bestBtn) return;
+
+    // Only useful when there is more than one page to choose from
+    ui->bestBtn->setVisible(combinationCount > 1 && optimizer.hasConflictFreeResult());
+
+    OptimizerScore score = optimizer.bestScore();
+    ui->bestBtn->setToolTip(QString("Best found so far: %1 hours over %2 days, %3 idle hours between classes\n"
+                                    "(%4 timetables tried%5)")
+                                .arg(score.totalHours)
+                                .arg(score.activeDays)
+                                .arg(score.gapHours)
+                                .arg(QLocale().toString(optimizer.iterations()))
+                                .arg(optimizer.isSettled() ? ", finished" : ", still searching"));
+}
+
 void TIMETABLE::onDelete()
 {
     // Confirm before clearing timetable view
@@ -369,7 +647,16 @@ void TIMETABLE::onDelete()
     if (msgBox.exec() == QMessageBox::Yes) {
         // Clear local timetable data only (does not affect ManageCoursesPage)
         coursesData.clear();
-        allCombinations.clear();
+        generationKey.clear();  // nothing to save for an empty view
+        engine.setCourses(coursesData);
+        combinationCount = 0;
+        currentCombinationIndex = 0;
+        pageCache.clear();
+        prerenderTimer->stop();
+        updateConstraintsLabel();
+        optimizerTimer->stop();
+        optimizer.setProblem(engine);
+        updateBestButton();
 
         // Refresh display
         populateTimetable();
@@ -387,175 +674,121 @@ void TIMETABLE::onDelete()
     }
 }
 
-// Main function that generates all valid timetable combinations
-// This will show all courses added by the user
-// If there are courses with same name but different times, it will generate
-// multiple combinations (one for each possible selection)
-void TIMETABLE::generateAllCombinations()
-{
-    // Group courses by their exact name and other details to identify unique vs duplicate entries
-    QMap<QString, QVector<Course>> courseGroups;
-
-    for (const Course &course : coursesData) {
-        // Create a unique key based on name, day, time, and classroom
-        QString key = QString("%1|%2|%3-%4|%5")
-                          .arg(course.name)
-                          .arg(course.day)
-                          .arg(course.startTime)
-                          .arg(course.endTime)
-                          .arg(course.classroom);
-
-        // Check if this exact course already exists in any group
-        bool found = false;
-        for (auto &group : courseGroups[course.name]) {
-            if (group.day == course.day &&
-                group.startTime == course.startTime &&
-                group.endTime == course.endTime &&
-                group.classroom == course.classroom) {
-                found = true;
-                break;
-            }
-        }
-
-        // Only add if not duplicate
-        if (!found) {
-            courseGroups[course.name].append(course);
-        }
-    }
-
-    // Check if all courses have unique names or if there are multiple options
-    bool hasMultipleOptions = false;
-    for (auto it = courseGroups.begin(); it != courseGroups.end(); ++it) {
-        if (it.value().size() > 1) {
-            hasMultipleOptions = true;
-            break;
-        }
-    }
-
-    // If no multiple options, just create one combination with all unique courses
-    if (!hasMultipleOptions) {
-        QVector<Course> uniqueCourses;
-        for (auto it = courseGroups.begin(); it != courseGroups.end(); ++it) {
-            uniqueCourses.append(it.value());
-        }
-        allCombinations.append(uniqueCourses);
+// Display the current combination on the timetable
+// Visited and pre-rendered pages come from the cache, so paging back and
+// forth only copies a picture to the screen
+void TIMETABLE::displayCurrentCombination()
+{
+    if (currentCombinationIndex >= combinationCount) {
         return;
     }
+    ALLOC_SCOPE(AllocOperation::FlipPage);
 
-    // Otherwise, generate combinations for courses with multiple time options
-    QList<QVector<Course>> groups;
-    for (auto it = courseGroups.begin(); it != courseGroups.end(); ++it) {
-        groups.append(it.value());
-    }
+    RenderedPage *page = renderedPage(currentCombinationIndex);
+    currentVariantCount = page->variantCount;
 
-    if (groups.isEmpty()) return;
+    ui->timetableGrid->setPage(page->blocks, page->pixmap);
+    showStatistics(page->courses.size(), page->totalHours, page->conflicts);
 
-    // use recursion to try all combinations (including conflicting ones)
-    QVector<Course> currentCombination;
-    generateCombinationsRecursive(groups, 0, currentCombination);
+    // get the pages on either side ready once the user pauses
+    prerenderTimer->start();
 }
 
-// This is where the magic happens - recursively builds all combinations
-// Think of it like a decision tree: for each course, try all its time options
-void TIMETABLE::generateCombinationsRecursive(const QList<QVector<Course>> &groups,
-                                               int groupIndex,
-                                               QVector<Course> &currentCombination)
+// Looks a page up in the cache, rendering it first if it is missing or
+// was rendered for a different window size
+RenderedPage *TIMETABLE::renderedPage(quint64 index)
 {
-    // done! we've picked one option for each course
-    if (groupIndex >= groups.size()) {
-        // Save all combinations, even if they have conflicts
-        // The user wants to see all possible timetables
-        allCombinations.append(currentCombination);
-        return;
-    }
-
-    // try each possible time slot for this course
-    const QVector<Course> &currentGroup = groups[groupIndex];
-    for (const Course &course : currentGroup) {
-        currentCombination.append(course);  // try this option
-
-        // recursively fill in the rest of the courses
-        generateCombinationsRecursive(groups, groupIndex + 1, currentCombination);
-
-        // backtrack - undo this choice and try the next option
-        currentCombination.removeLast();
+    RenderedPage *page = pageCache.object(index);
+    if (page && ui->timetableGrid->fitsWidget(page->pixmap)) {
+        METRICS_COUNT(Metric::PageCacheHits, 1);
+        return page;
     }
+    METRICS_SCOPE(Metric::RenderPage);
+    TRACE_SCOPE("ui", "render page");
+
+    // Looked up directly by page index - earlier pages are never generated
+    QVector<int> choices = engine.choicesAt(index);
+
+    page = new RenderedPage;
+    page->courses = engine.combinationFromChoices(choices);
+    page->variantCount = engine.variantCount(choices);
+    page->totalHours = calculateTotalHours(page->courses);
+    page->conflicts = detectConflicts(page->courses);
+    TimetableRenderer::layoutBlocks(page->courses, page->blocks);
+    page->pixmap = ui->timetableGrid->renderPage(page->blocks);
+
+    // never above the limit, or the cache would delete the page right away
+    const qsizetype bytes = qsizetype(page->pixmap.width()) * page->pixmap.height() * page->pixmap.depth() / 8;
+    const qsizetype costKB = qBound<qsizetype>(1, bytes / 1024, pageCache.maxCost());
+    pageCache.insert(index, page, costKB);
+    return page;
 }
 
-// Check if a combination of courses has any time conflicts
-bool TIMETABLE::hasConflict(const QVector<Course> &combination)
+// Renders the next and previous pages (wrapping like the buttons do),
+// one per tick so input is never blocked for long
+void TIMETABLE::onPrerenderTick()
 {
-    for (int i = 0; i < combination.size(); ++i) {
-        for (int j = i + 1; j < combination.size(); ++j) {
-            const Course &c1 = combination[i];
-            const Course &c2 = combination[j];
-
-            // Check if same day
-            if (c1.day != c2.day) continue;
+    if (!isVisible() || combinationCount <= 1) return;
 
-            // Convert times to columns
-            int start1 = timeToColumn(c1.startTime);
-            int end1 = timeToColumn(c1.endTime);
-            int start2 = timeToColumn(c2.startTime);
-            int end2 = timeToColumn(c2.endTime);
+    const quint64 next = (currentCombinationIndex + 1) % combinationCount;
+    const quint64 prev = (currentCombinationIndex + combinationCount - 1) % combinationCount;
 
-            // Check for time overlap
-            if (!(end1 <= start2 || end2 <= start1)) {
-                return true;  // Conflict found
-            }
+    for (quint64 index : { next, prev }) {
+        RenderedPage *page = pageCache.object(index);
+        if (!page || !ui->timetableGrid->fitsWidget(page->pixmap)) {
+            renderedPage(index);
+            prerenderTimer->start();  // the other neighbour on the next tick
+            return;
         }
     }
-    return false;  // No conflicts
 }
 
-// Display the current combination on the timetable
-void TIMETABLE::displayCurrentCombination()
+// A top-level UpdateRequest repaints every dirty child of the window,
+// so timing it gives the cost of one whole frame
+bool TIMETABLE::event(QEvent *event)
 {
-    if (allCombinations.isEmpty() || currentCombinationIndex < 0 ||
-        currentCombinationIndex >= allCombinations.size()) {
-        return;
-    }
-
-    // Temporarily set coursesData to the current combination
-    QVector<Course> originalData = coursesData;
-    coursesData = allCombinations[currentCombinationIndex];
-
-    // Populate the timetable with this combination
-    populateTimetable();
-
-    // Update statistics for current combination (use the current combination data)
-    updateStatistics();
-
-    // Restore original data AFTER updating statistics
-    coursesData = originalData;
+    TRACE_SCOPE_IF(event->type() == QEvent::UpdateRequest, "paint", "TIMETABLE repaint");
+    return QDialog::event(event);
 }
 
 // Update the page label to show current page
 void TIMETABLE::updatePageLabel()
 {
-    if (!allCombinations.isEmpty()) {
-        // Update the page number label
+    if (combinationCount > 0) {
+        // Update the page number label, e.g. "1 of 3,481,920"
+        QLocale locale;
         if (ui->pageNumberLabel) {
-            ui->pageNumberLabel->setText(QString("%1/%2")
-                                         .arg(currentCombinationIndex + 1)
-                                         .arg(allCombinations.size()));
+            ui->pageNumberLabel->setText(QString("%1 of %2")
+                                         .arg(locale.toString(currentCombinationIndex + 1))
+                                         .arg(locale.toString(combinationCount)));
         }
 
+        if (ui->exportAllBtn) ui->exportAllBtn->show();
+
         // Show/hide navigation buttons based on number of pages
-        if (allCombinations.size() > 1) {
+        if (combinationCount > 1) {
             if (ui->prevPageBtn) ui->prevPageBtn->show();
             if (ui->nextPageBtn) ui->nextPageBtn->show();
             if (ui->pageNumberLabel) ui->pageNumberLabel->show();
+            if (ui->pageJumpInput) ui->pageJumpInput->show();
+            if (ui->compareBtn) ui->compareBtn->show();
         } else {
             if (ui->prevPageBtn) ui->prevPageBtn->hide();
             if (ui->nextPageBtn) ui->nextPageBtn->hide();
             if (ui->pageNumberLabel) ui->pageNumberLabel->hide();
+            if (ui->pageJumpInput) ui->pageJumpInput->hide();
+            if (ui->compareBtn) ui->compareBtn->hide();
         }
 
         // Update window title
-        this->setWindowTitle(QString("View Timetable - Page %1 of %2")
-                             .arg(currentCombinationIndex + 1)
-                             .arg(allCombinations.size()));
+        // Mention when this page stands for several same-grid timetables
+        QString title = QString("View Timetable - Page %1 of %2")
+                            .arg(locale.toString(currentCombinationIndex + 1))
+                            .arg(locale.toString(combinationCount));
+        if (currentVariantCount > 1) {
+            title += QString(" (%1 classroom variants)").arg(locale.toString(currentVariantCount));
+        }
+        this->setWindowTitle(title);
     } else {
         if (ui->pageNumberLabel) {
             ui->pageNumberLabel->setText("1/1");
@@ -563,6 +796,48 @@ void TIMETABLE::updatePageLabel()
         if (ui->prevPageBtn) ui->prevPageBtn->hide();
         if (ui->nextPageBtn) ui->nextPageBtn->hide();
         if (ui->pageNumberLabel) ui->pageNumberLabel->hide();
+        if (ui->pageJumpInput) ui->pageJumpInput->hide();
+        if (ui->compareBtn) ui->compareBtn->hide();
+        if (ui->exportAllBtn) ui->exportAllBtn->hide();
         this->setWindowTitle("View Timetable - No valid combinations");
     }
 }
+
+#ifdef TIMETABLE_METRICS
+void TIMETABLE::toggleMetricsOverlay()
+{
+    if (metricsOverlay->isVisible()) {
+        metricsTimer->stop();
+        metricsOverlay->hide();
+        return;
+    }
+
+    refreshMetricsOverlay();
+    metricsOverlay->show();
+    metricsTimer->start();
+}
+
+// Totals since the program started, plus what the current course set pruned
+void TIMETABLE::refreshMetricsOverlay()
+{
+    const PruneReport &report = engine.pruneReport();
+    QLocale locale;
+
+    metricsOverlay->setText(QString("timetables           %1\n"
+                                    "sections pruned      %2\n"
+                                    "memo entries         %3\n"
+                                    "spilled to disk      %4 (%5 MB file)\n\n%6")
+                                .arg(locale.toString(combinationCount))
+                                .arg(report.excludedSections + report.lockedOutSections + report.outsideTimeWindow)
+                                .arg(locale.toString(engine.memoSize()))
+                                .arg(locale.toString(engine.spilledEntries()))
+                                .arg(engine.spillFileBytes() / (1024 * 1024))
+                                .arg(PerfMetrics::summary()));
+#ifdef TIMETABLE_ALLOC_STATS
+    metricsOverlay->setText(metricsOverlay->text() + "\n\n" + AllocStats::summary());
+#endif
+    metricsOverlay->adjustSize();
+    metricsOverlay->move(8, 8);
+    metricsOverlay->raise();
+}
+#endif
@@ -7,13 +7,37 @@
 #include <QMap>
 #include <QPair>
 #include <QSet>
+#include <QPointer>
+#include <QCache>
+#include <QPixmap>
+#include "timetableengine.h"
+#include "timetableoptimizer.h"
+#include "timetablerenderer.h"
 
 namespace Ui {
 class TIMETABLE;
 }
 
+class QTimer;
+class QLabel;
+class QProgressDialog;
+class TimetableExporter;
+class TimetableCompareDialog;
+class GenerationCache;
+
 struct Course;  // Forward declaration
 
+// One timetable page ready to show: its courses, their grid layout, a
+// picture of the grid and the numbers in the statistics bar
+struct RenderedPage {
+    QVector<Course> courses;
+    QVector<TimetableRenderer::Block> blocks;  // Cell texts built once, shared with the grid
+    QPixmap pixmap;
+    quint64 variantCount = 1;
+    int totalHours = 0;
+    int conflicts = 0;
+};
+
 class TIMETABLE : public QDialog
 {
     Q_OBJECT
@@ -23,7 +47,16 @@ public:
     ~TIMETABLE();
 
     // Set course data to populate timetable
-    void setCoursesData(const QVector<Course> &courses);
+    // Locks/exclusions come from each Course, the time window from constraints
+    void setCoursesData(const QVector<Course> &courses,
+                        const ScheduleConstraints &constraints = ScheduleConstraints());
+
+    // Results for the same courses are reused from (and saved to) this cache
+    // Call before setCoursesData(); the cache must outlive the window
+    void setGenerationCache(GenerationCache *cache);
+
+protected:
+    bool event(QEvent *event) override;
 
 private slots:
     void onSaveAs();
@@ -31,31 +64,70 @@ private slots:
     void onPrevPage();
     void onNextPage();
     void onTogglePage();  // New: Toggle between pages with single button
+    void onJumpToPage();  // Jump straight to the page typed in pageJumpInput
+    void onShowBest();    // Jump to the best timetable the optimizer has found
+    void onOptimizerTick();  // Give the optimizer another time slice
+    void onPrerenderTick();  // Render the neighbouring pages while idle
+    void onExportAll();   // Export every page (or the first N) in one pass
+    void onCompare();     // Show many pages side by side as thumbnails
     void onDelete();
 
 private:
     void populateTimetable();
     void updateStatistics();
-    int calculateTotalHours();
-    int detectConflicts();
+    void showStatistics(int totalCourses, int totalHours, int conflicts);
+    void updateConstraintsLabel();
+    void setSavingInProgress(bool busy);
+    QVector<Course> currentPageCourses();
+    int calculateTotalHours(const QVector<Course> &courses);
+    int detectConflicts(const QVector<Course> &courses);
     int timeToColumn(const QString &time);
     int dayToRow(const QString &day);
 
-    // New methods for generating all possible timetable combinations
-    void generateAllCombinations();
-    void generateCombinationsRecursive(const QList<QVector<Course>> &groups,
-                                       int groupIndex,
-                                       QVector<Course> &currentCombination);
-    bool hasConflict(const QVector<Course> &combination);
+    // Methods for paging through the conflict-free timetable combinations
     void displayCurrentCombination();
     void updatePageLabel();
+    RenderedPage *renderedPage(quint64 index);
 
     Ui::TIMETABLE *ui;
     QVector<Course> coursesData;  // All courses added by user
 
-    // New members for handling multiple timetable combinations
-    QVector<QVector<Course>> allCombinations;  // All valid non-conflicting combinations
-    int currentCombinationIndex;  // Current page index
+    // Members for handling multiple timetable combinations
+    // Pages are looked up by index in the engine, never stored as a list
+    TimetableEngine engine;
+    quint64 combinationCount;  // Number of valid non-conflicting combinations
+    quint64 currentCombinationIndex;  // Current page index
+    quint64 currentVariantCount;  // Timetables folded into the current page (room variants)
+
+    // Recently visited and pre-rendered pages, most recently used kept
+    // (cost is the picture size in KB)
+    QCache<quint64, RenderedPage> pageCache;
+    QTimer *prerenderTimer;
+
+    // Anytime optimizer, refined in small slices while the window is open
+    TimetableOptimizer optimizer;
+    QTimer *optimizerTimer;
+    void updateBestButton();
+
+    // Cache of earlier results, and the key of the current course set
+    GenerationCache *generationCache;
+    QString generationKey;
+    void storeGenerationResult();
+
+    // Bulk export running in the background (deletes itself when done)
+    QPointer<TimetableExporter> exporter;
+    QProgressDialog *exportProgress;
+
+    // Thumbnail comparison view (uses this window's engine while open)
+    QPointer<TimetableCompareDialog> compareDialog;
+
+#ifdef TIMETABLE_METRICS
+    // Debug overlay with the hot-path metrics, toggled with Ctrl+Shift+M
+    QLabel *metricsOverlay;
+    QTimer *metricsTimer;
+    void toggleMetricsOverlay();
+    void refreshMetricsOverlay();
+#endif
 };
 
 #endif // TIMETABLE_H
@@ -0,0 +1,84 @@
+/**
+ * TimetableCompareDialog Implementation File
+ */
+
+#include "timetablecomparedialog.h"
+#include "timetablethumbnailmodel.h"
+#include <QVBoxLayout>
+#include <QLocale>
+
+TimetableCompareDialog::TimetableCompareDialog(TimetableEngine *engine, quint64 pageCount, QWidget *parent)
+    : QDialog(parent)
+{
+    // Set window properties
+    setWindowTitle("Compare Timetables");
+    resize(1400, 800);
+    setStyleSheet("QDialog { background-color: #0D1B2A; }");
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setSpacing(10);
+    layout->setContentsMargins(20, 20, 20, 20);
+
+    hintLabel = new QLabel(QString("%1 timetable(s) - click one to open it")
+                               .arg(QLocale().toString(pageCount)), this);
+    hintLabel->setStyleSheet(
+        "QLabel {"
+        "   color: white;"
+        "   font-size: 14px;"
+        "   font-weight: bold;"
+        "}"
+    );
+
+    // Icon-mode list: the view only asks the model for rows on screen,
+    // so only visible thumbnails are ever rendered
+    model = new TimetableThumbnailModel(engine, pageCount, this);
+
+    thumbnailView = new QListView(this);
+    thumbnailView->setViewMode(QListView::IconMode);
+    thumbnailView->setResizeMode(QListView::Adjust);
+    thumbnailView->setMovement(QListView::Static);
+    thumbnailView->setLayoutMode(QListView::Batched);
+    thumbnailView->setUniformItemSizes(true);  // no per-row size queries
+    thumbnailView->setIconSize(TimetableThumbnailModel::thumbnailSize());
+    thumbnailView->setSpacing(12);
+    thumbnailView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    thumbnailView->setSelectionMode(QAbstractItemView::SingleSelection);
+    thumbnailView->setModel(model);
+    thumbnailView->setStyleSheet(
+        "QListView {"
+        "   background-color: #0D1B2A;"
+        "   color: white;"
+        "   border: 1px solid #2d5a8c;"
+        "}"
+        "QListView::item:selected {"
+        "   background-color: #2d5a8c;"
+        "}"
+    );
+
+    layout->addWidget(hintLabel);
+    layout->addWidget(thumbnailView);
+
+    connect(thumbnailView, &QListView::clicked, this, &TimetableCompareDialog::onThumbnailActivated);
+    connect(thumbnailView, &QListView::activated, this, &TimetableCompareDialog::onThumbnailActivated);
+}
+
+void TimetableCompareDialog::showPage(quint64 page)
+{
+    // pages further down are loaded the same way scrolling would load them
+    while (page >= quint64(model->rowCount()) && model->canFetchMore(QModelIndex())) {
+        model->fetchMore(QModelIndex());
+    }
+    if (page >= quint64(model->rowCount())) return;
+
+    QModelIndex index = model->index(int(page));
+    thumbnailView->setCurrentIndex(index);
+    thumbnailView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+void TimetableCompareDialog::onThumbnailActivated(const QModelIndex &index)
+{
+    if (!index.isValid()) return;
+
+    emit pageSelected(index.data(TimetableThumbnailModel::PageIndexRole).value<quint64>());
+    accept();
+}
@@ -0,0 +1,53 @@
+/**
+ * TimetableCompareDialog Header File
+ *
+ * This file defines the comparison view that shows many timetable pages
+ * at once as thumbnails.
+ */
+
+#ifndef TIMETABLECOMPAREDIALOG_H
+#define TIMETABLECOMPAREDIALOG_H
+
+#include <QDialog>
+#include <QListView>
+#include <QLabel>
+
+class TimetableEngine;
+class TimetableThumbnailModel;
+
+/**
+ * TimetableCompareDialog Class
+ *
+ * Shows many timetable pages side by side as small thumbnails, so the
+ * student can compare them at a glance instead of paging one by one.
+ * Clicking a thumbnail opens that page in the TIMETABLE window.
+ */
+class TimetableCompareDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param engine: Engine of the TIMETABLE window (must outlive the dialog)
+     * @param pageCount: Number of pages to show
+     */
+    TimetableCompareDialog(TimetableEngine *engine, quint64 pageCount, QWidget *parent = nullptr);
+
+    /**
+     * Scrolls so the given page is in view and selected
+     */
+    void showPage(quint64 page);
+
+signals:
+    void pageSelected(quint64 page);
+
+private slots:
+    void onThumbnailActivated(const QModelIndex &index);
+
+private:
+    QLabel *hintLabel;
+    QListView *thumbnailView;
+    TimetableThumbnailModel *model;
+};
+
+#endif // TIMETABLECOMPAREDIALOG_H
@@ -0,0 +1,680 @@
+/**
+ * TimetableEngine Implementation File
+ *
+ * Implements course grouping, memoized counting of conflict-free
+ * timetables and direct lookup of a timetable by its page index.
+ */
+
+#include "timetableengine.h"
+#include "managecoursespage.h"
+#include "perfmetrics.h"
+#include "tracer.h"
+#include "memospill.h"
+#include <QMap>
+#include <QStringList>
+#include <QDataStream>
+#include <QRandomGenerator>
+#include <limits>
+
+namespace {
+
+// adds two counts, sticking at the maximum instead of wrapping around
+quint64 saturatingAdd(quint64 a, quint64 b)
+{
+    const quint64 maxCount = std::numeric_limits<quint64>::max();
+    return (b > maxCount - a) ? maxCount : a + b;
+}
+
+// multiplies two counts, sticking at the maximum instead of wrapping around
+quint64 saturatingMultiply(quint64 a, quint64 b)
+{
+    const quint64 maxCount = std::numeric_limits<quint64>::max();
+    return (b != 0 && a > maxCount / b) ? maxCount : a * b;
+}
+
+const quint32 MemoMagic = 0x54454D31;  // "TEM1"
+
+// the clock is read once per this many DP states
+const quint64 NodesPerDeadlineCheck = 1024;
+
+// random walks behind estimatedTotal()
+const int EstimateProbes = 512;
+
+// heap cost of one QHash memo entry (key, count, node and bucket share)
+const qint64 MemoEntryBytes = 48;
+
+qint64 defaultMemoryBudget = 512LL * 1024 * 1024;
+
+int budgetEntries(qint64 bytes)
+{
+    return int(qBound<qint64>(1024, bytes / MemoEntryBytes, std::numeric_limits<int>::max()));
+}
+
+} // namespace
+
+TimetableEngine::TimetableEngine()
+    : memoBudgetEntries(budgetEntries(defaultMemoryBudget))
+    , spillFailed(false)
+    , counted(false)
+    , fullCount(0)
+    , limitHit(false)
+    , nodeCount(0)
+    , collapsedSections(0)
+{
+}
+
+void TimetableEngine::setMemoryBudget(qint64 bytes)
+{
+    memoBudgetEntries = budgetEntries(bytes);
+}
+
+void TimetableEngine::setDefaultMemoryBudget(qint64 bytes)
+{
+    defaultMemoryBudget = bytes;
+}
+
+// Group courses by name the same way the old generator did:
+// sections keep their insertion order, exact duplicates are dropped,
+// and groups are ordered by course name (QMap keeps keys sorted)
+void TimetableEngine::setCourses(const QVector<Course> &courses,
+                                 const ScheduleConstraints &constraints)
+{
+    METRICS_SCOPE(Metric::EngineSetup);
+    TRACE_SCOPE("engine", "setCourses");
+
+    sourceCourses.clear();
+    groups.clear();
+    remainingDays.clear();
+    memo.clear();
+    spill = SpillFiles();  // other engine copies keep their own references
+    spillFailed = false;
+    counted = false;
+    limitHit = false;
+    collapsedSections = 0;
+    report = PruneReport();
+    report.searchSpaceBefore = 1;
+    report.searchSpaceAfter = 1;
+
+    // -1 means no limit (also for "10pm", the end of the day anyway)
+    const int earliestStart = hourIndex(constraints.earliestStart);
+    const int latestEnd = hourIndex(constraints.latestEnd);
+
+    QMap<QString, QVector<int>> courseGroups;
+
+    for (const Course &course : courses) {
+        // Check if this exact course already exists in its group
+        bool found = false;
+        for (int index : courseGroups.value(course.name)) {
+            const Course &existing = sourceCourses[index];
+            if (existing.day == course.day &&
+                existing.startTime == course.startTime &&
+                existing.endTime == course.endTime &&
+                existing.classroom == course.classroom) {
+                found = true;
+                break;
+            }
+        }
+
+        // Only add if not duplicate
+        if (!found) {
+            sourceCourses.append(course);
+            courseGroups[course.name].append(sourceCourses.size() - 1);
+        }
+    }
+
+    // Convert every section into its compact day/hour-mask form
+    for (auto it = courseGroups.begin(); it != courseGroups.end(); ++it) {
+        report.searchSpaceBefore = saturatingMultiply(report.searchSpaceBefore,
+                                                      it.value().size());
+
+        // Domain filters: exclusions first, then locks, then the time window
+        QVector<int> candidates;
+        bool hasLock = false;
+        for (int index : it.value()) {
+            const Course &course = sourceCourses[index];
+            if (course.preference == SectionPreference::Excluded) {
+                report.excludedSections++;
+                continue;
+            }
+            if (course.preference == SectionPreference::Locked) {
+                hasLock = true;
+            }
+            candidates.append(index);
+        }
+
+        QVector<Section> group;
+
+        // canonical grid key -> position in group, to fold equivalent sections
+        QHash<quint32, int> sectionByGrid;
+
+        for (int index : candidates) {
+            const Course &course = sourceCourses[index];
+            int day = dayIndex(course.day);
+            int start = hourIndex(course.startTime);
+            int end = hourIndex(course.endTime);
+
+            // a locked section pushes out every other section of the course
+            if (hasLock && course.preference != SectionPreference::Locked) {
+                report.lockedOutSections++;
+                continue;
+            }
+
+            // sections with unreadable times are kept, there is nothing to compare
+            if (start >= 0 && end >= 0 &&
+                ((earliestStart >= 0 && start < earliestStart) ||
+                 (latestEnd >= 0 && end > latestEnd))) {
+                report.outsideTimeWindow++;
+                continue;
+            }
+
+            Section section;
+            section.day = qMax(day, 0);
+            section.mask = 0;
+
+            // invalid sections are shown as-is but never block anything
+            if (day >= 0 && start >= 0 && end >= 0 && start < end) {
+                section.mask = quint16(((1u << end) - 1) & ~((1u << start) - 1));
+            }
+
+            // same day and hours = same cells on the grid, whatever the room
+            // (invalid sections draw nothing, so they all share key 0)
+            quint32 gridKey = section.mask ? (quint32(section.day) << 16) | section.mask : 0;
+            auto existing = sectionByGrid.constFind(gridKey);
+            if (existing != sectionByGrid.constEnd()) {
+                group[existing.value()].variants.append(index);
+                collapsedSections++;
+                continue;
+            }
+
+            section.variants.append(index);
+            sectionByGrid.insert(gridKey, group.size());
+            group.append(section);
+        }
+
+        // an empty group keeps its place so the count correctly drops to 0
+        if (group.isEmpty()) {
+            report.emptyGroups++;
+        }
+        report.searchSpaceAfter = saturatingMultiply(report.searchSpaceAfter, group.size());
+        groups.append(group);
+    }
+
+    if (groups.isEmpty()) {
+        report.searchSpaceBefore = 0;
+        report.searchSpaceAfter = 0;
+    }
+
+    // remainingDays[g] = days that groups g, g+1, ... can still occupy
+    remainingDays.fill(0, groups.size() + 1);
+    for (int g = groups.size() - 1; g >= 0; --g) {
+        quint8 days = remainingDays[g + 1];
+        for (const Section &section : groups[g]) {
+            if (section.mask) {
+                days |= quint8(1u << section.day);
+            }
+        }
+        remainingDays[g] = days;
+    }
+}
+
+const PruneReport &TimetableEngine::pruneReport() const
+{
+    return report;
+}
+
+int TimetableEngine::groupCount() const
+{
+    return groups.size();
+}
+
+void TimetableEngine::setLimits(const GenerationLimits &newLimits)
+{
+    limits = newLimits;
+}
+
+quint64 TimetableEngine::validCount()
+{
+    if (groups.isEmpty()) return 0;
+
+    if (!counted) {
+        nodeCount = 0;
+        countTimer.start();
+        Occupancy empty = {};
+        fullCount = countFrom(0, empty);
+        counted = true;
+    }
+
+    if (limits.maxResults > 0 && fullCount > limits.maxResults) return limits.maxResults;
+    return fullCount;
+}
+
+bool TimetableEngine::isTruncated()
+{
+    return validCount() < fullCount || limitHit;
+}
+
+// Knuth's estimator: walk down the tree picking a random fitting section
+// per group; the product of the branching factors is an unbiased guess of
+// the number of leaves. Averaged over a fixed number of seeded walks.
+quint64 TimetableEngine::estimatedTotal()
+{
+    validCount();  // fills fullCount: what was counted before a limit hit
+    if (!limitHit) return fullCount;
+
+    QRandomGenerator random(1);
+    double sum = 0;
+    QVector<int> fitting;
+    for (int probe = 0; probe < EstimateProbes; ++probe) {
+        Occupancy occupancy = {};
+        double leaves = 1;
+        for (const QVector<Section> &group : groups) {
+            fitting.clear();
+            for (int s = 0; s < group.size(); ++s) {
+                if (!(occupancy.day[group[s].day] & group[s].mask)) fitting.append(s);
+            }
+            if (fitting.isEmpty()) {
+                leaves = 0;
+                break;
+            }
+
+            leaves *= fitting.size();
+            const Section &chosen = group[fitting[random.bounded(int(fitting.size()))]];
+            occupancy.day[chosen.day] |= chosen.mask;
+        }
+        sum += leaves;
+    }
+
+    const double estimate = sum / EstimateProbes;
+    if (estimate >= double(std::numeric_limits<quint64>::max())) return std::numeric_limits<quint64>::max();
+    // never below what was really counted (validCount() is capped by maxResults)
+    return qMax(fullCount, quint64(estimate));
+}
+
+// Walks down the decision tree once, skipping whole subtrees whose
+// size is already known from the memo: O(groups x sections) lookups
+QVector<int> TimetableEngine::choicesAt(quint64 index)
+{
+    METRICS_SCOPE(Metric::Unrank);
+    TRACE_SCOPE("engine", "choicesAt");
+
+    QVector<int> choices;
+    if (index >= validCount()) return choices;
+
+    choices.reserve(groups.size());
+    Occupancy occupancy = {};
+    for (int g = 0; g < groups.size(); ++g) {
+        const QVector<Section> &group = groups[g];
+        int chosen = -1;
+
+        for (int s = 0; s < group.size(); ++s) {
+            const Section &section = group[s];
+            if (occupancy.day[section.day] & section.mask) continue;
+
+            Occupancy next = occupancy;
+            next.day[section.day] |= section.mask;
+
+            // the whole subtree under this section is either skipped or entered
+            quint64 subtree = countFrom(g + 1, next);
+            if (index < subtree) {
+                occupancy = next;
+                chosen = s;
+                break;
+            }
+            index -= subtree;
+        }
+
+        // only reachable if a count saturated
+        if (chosen < 0) return QVector<int>();
+        choices.append(chosen);
+    }
+
+    return choices;
+}
+
+QVector<Course> TimetableEngine::combinationAt(quint64 index)
+{
+    return combinationFromChoices(choicesAt(index));
+}
+
+QVector<Course> TimetableEngine::combinationFromChoices(const QVector<int> &choices) const
+{
+    QVector<Course> combination;
+    if (choices.size() != groups.size()) return combination;
+
+    combination.reserve(choices.size());
+    for (int g = 0; g < groups.size(); ++g) {
+        const Section &section = groups[g][choices[g]];
+        Course course = sourceCourses[section.variants.first()];
+
+        // list every interchangeable classroom in the one cell
+        if (section.variants.size() > 1) {
+            QStringList classrooms;
+            for (int index : section.variants) {
+                if (!classrooms.contains(sourceCourses[index].classroom)) {
+                    classrooms.append(sourceCourses[index].classroom);
+                }
+            }
+            course.classroom = classrooms.join(" / ");
+        }
+        combination.append(course);
+    }
+    return combination;
+}
+
+quint64 TimetableEngine::variantCount(const QVector<int> &choices) const
+{
+    if (choices.size() != groups.size()) return 0;
+
+    quint64 total = 1;
+    for (int g = 0; g < groups.size(); ++g) {
+        total = saturatingMultiply(total, groups[g][choices[g]].variants.size());
+    }
+    return total;
+}
+
+int TimetableEngine::collapsedSectionCount() const
+{
+    return collapsedSections;
+}
+
+// Adds up the subtrees of every earlier sibling on the path of the choices
+quint64 TimetableEngine::rankOf(const QVector<int> &choices)
+{
+    const quint64 count = validCount();
+    if (choices.size() != groups.size()) return count;
+
+    quint64 rank = 0;
+    Occupancy occupancy = {};
+    for (int g = 0; g < groups.size(); ++g) {
+        const QVector<Section> &group = groups[g];
+        if (choices[g] < 0 || choices[g] >= group.size()) return count;
+
+        for (int s = 0; s < choices[g]; ++s) {
+            const Section &section = group[s];
+            if (occupancy.day[section.day] & section.mask) continue;
+
+            Occupancy next = occupancy;
+            next.day[section.day] |= section.mask;
+            rank = saturatingAdd(rank, countFrom(g + 1, next));
+        }
+
+        const Section &chosen = group[choices[g]];
+        if (occupancy.day[chosen.day] & chosen.mask) return count;
+        occupancy.day[chosen.day] |= chosen.mask;
+    }
+
+    return rank;
+}
+
+// FNV-1a over the compact sections (day and hours, in order): the memo
+// only depends on these, not on names or classrooms
+quint64 TimetableEngine::layoutFingerprint() const
+{
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](quint64 value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+
+    mix(quint64(groups.size()));
+    for (const QVector<Section> &group : groups) {
+        mix(quint64(group.size()));
+        for (const Section &section : group) {
+            mix((quint64(section.day) << 16) | section.mask);
+        }
+    }
+    return hash;
+}
+
+int TimetableEngine::memoSize() const
+{
+    return memo.size() + spilledEntries();
+}
+
+int TimetableEngine::spilledEntries() const
+{
+    qsizetype entries = spill.own ? spill.own->size() : 0;
+    for (const auto &file : spill.shared) entries += file->size();
+    return int(entries);
+}
+
+qint64 TimetableEngine::spillFileBytes() const
+{
+    qint64 bytes = spill.own ? spill.own->fileBytes() : 0;
+    for (const auto &file : spill.shared) bytes += file->fileBytes();
+    return bytes;
+}
+
+void TimetableEngine::spillToDisk()
+{
+    if (!memo.isEmpty()) spillMemo();
+}
+
+QByteArray TimetableEngine::saveMemo() const
+{
+    // partial counts from a stopped count must never be reused
+    if (limitHit) return QByteArray();
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+
+    out << MemoMagic << layoutFingerprint() << quint32(memoSize());
+    for (auto it = memo.constBegin(); it != memo.constEnd(); ++it) {
+        out << it.key().low << it.key().high << it.value();
+    }
+    // a key is in at most one place: lookups check RAM, own file, shared files
+    auto write = [&out](quint64 low, quint64 high, quint64 count) {
+        out << low << high << count;
+    };
+    if (spill.own) spill.own->forEach(write);
+    for (const auto &file : spill.shared) file->forEach(write);
+    return data;
+}
+
+bool TimetableEngine::restoreMemo(const QByteArray &data)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint64 fingerprint = 0;
+    quint32 size = 0;
+    in >> magic >> fingerprint >> size;
+    if (in.status() != QDataStream::Ok || magic != MemoMagic || fingerprint != layoutFingerprint()) {
+        return false;
+    }
+
+    QHash<StateKey, quint64> restored;
+    restored.reserve(size);
+    for (quint32 i = 0; i < size; ++i) {
+        StateKey key;
+        quint64 count = 0;
+        in >> key.low >> key.high >> count;
+        if (in.status() != QDataStream::Ok) return false;
+        restored.insert(key, count);
+    }
+
+    memo.swap(restored);
+    spill = SpillFiles();
+    counted = false;
+    if (memo.size() > memoBudgetEntries) spillMemo();
+    return true;
+}
+
+int TimetableEngine::sectionCount(int groupIndex) const
+{
+    return groups[groupIndex].size();
+}
+
+int TimetableEngine::sectionDay(int groupIndex, int sectionIndex) const
+{
+    return groups[groupIndex][sectionIndex].day;
+}
+
+quint16 TimetableEngine::sectionMask(int groupIndex, int sectionIndex) const
+{
+    return groups[groupIndex][sectionIndex].mask;
+}
+
+// Number of ways to finish a timetable from groupIndex onwards,
+// given the hours already taken by earlier groups
+quint64 TimetableEngine::countFrom(int groupIndex, const Occupancy &occupancy)
+{
+    if (groupIndex >= groups.size()) return 1;
+
+    const StateKey key = makeKey(groupIndex, occupancy);
+    auto cached = memo.constFind(key);
+    if (cached != memo.constEnd()) {
+        METRICS_COUNT(Metric::MemoHits, 1);
+        return cached.value();
+    }
+    quint64 spilled = 0;
+    if (spill.find(key.low, key.high, spilled)) {
+        METRICS_COUNT(Metric::MemoHits, 1);
+        return spilled;
+    }
+
+    // out of budget: everything not counted yet counts as 0
+    if (limitHit) return 0;
+    nodeCount++;
+    if ((limits.maxNodes > 0 && nodeCount > limits.maxNodes) ||
+        (limits.deadlineMs > 0 && nodeCount % NodesPerDeadlineCheck == 0 &&
+         countTimer.elapsed() >= limits.deadlineMs)) {
+        limitHit = true;
+        return 0;
+    }
+    METRICS_COUNT(Metric::NodesExplored, 1);
+
+    quint64 total = 0;
+    for (const Section &section : groups[groupIndex]) {
+        // skip sections that overlap something already chosen
+        if (occupancy.day[section.day] & section.mask) {
+            METRICS_COUNT(Metric::BranchesPruned, 1);
+            continue;
+        }
+
+        Occupancy next = occupancy;
+        next.day[section.day] |= section.mask;
+        total = saturatingAdd(total, countFrom(groupIndex + 1, next));
+    }
+
+    memo.insert(key, total);
+    if (memo.size() > memoBudgetEntries) spillMemo();
+    return total;
+}
+
+// Moves the whole in-RAM memo into the spill file; if the file can't be
+// made or grown, what is left stays in RAM and spilling is not retried.
+// Entries leave the memo as they are written, so none are held twice.
+void TimetableEngine::spillMemo()
+{
+    if (spillFailed) return;
+    TRACE_SCOPE("engine", "spill memo");
+
+    if (!spill.own) {
+        spill.own.reset(new MemoSpill);
+        if (!spill.own->open()) {
+            qWarning("Timetable memo stays in memory: %s", qPrintable(spill.own->errorString()));
+            spill.own.reset();
+            spillFailed = true;
+            return;
+        }
+    }
+
+    for (auto it = memo.begin(); it != memo.end(); it = memo.erase(it)) {
+        if (!spill.own->insert(it.key().low, it.key().high, it.value())) {
+            qWarning("Timetable memo partly stays in memory: %s", qPrintable(spill.own->errorString()));
+            spillFailed = true;
+            memo.squeeze();
+            return;
+        }
+    }
+    memo.clear();  // frees the buckets
+}
+
+// A copy reads the original's files but never writes into them
+TimetableEngine::SpillFiles::SpillFiles(const SpillFiles &other)
+    : shared(other.shared)
+{
+    if (other.own) shared.append(other.own);
+}
+
+TimetableEngine::SpillFiles &TimetableEngine::SpillFiles::operator=(const SpillFiles &other)
+{
+    if (this != &other) {
+        QVector<QSharedPointer<const MemoSpill>> files = other.shared;
+        if (other.own) files.append(other.own);
+        own.reset();
+        shared = files;
+    }
+    return *this;
+}
+
+bool TimetableEngine::SpillFiles::find(quint64 low, quint64 high, quint64 &count) const
+{
+    if (own && own->find(low, high, count)) return true;
+    for (const auto &file : shared) {
+        if (file->find(low, high, count)) return true;
+    }
+    return false;
+}
+
+// Packs the days that still matter into 98 bits; the group index goes
+// into the top 16 bits of the high word
+TimetableEngine::StateKey TimetableEngine::makeKey(int groupIndex, const Occupancy &occupancy) const
+{
+    const quint8 days = remainingDays[groupIndex];
+
+    StateKey key = { 0, quint64(groupIndex) << 48 };
+    for (int d = 0; d < DayCount; ++d) {
+        if (!(days & (1u << d))) continue;
+
+        quint64 bits = occupancy.day[d];
+        if (d < 4) {
+            key.low |= bits << (d * HourCount);
+        } else {
+            key.high |= bits << ((d - 4) * HourCount);
+        }
+    }
+    return key;
+}
+
+// converts time string (like "8am", "2pm") into an hour column
+// our timetable starts at 8am, so 8am = column 0, 9am = column 1, etc
+int TimetableEngine::hourIndex(const QString &time)
+{
+    QString t = time.toLower().trimmed();
+    bool isPM = t.contains("pm");
+
+    // clean up the string - remove am/pm and .00
+    QString numStr = t;
+    numStr.remove("am").remove("pm").remove(".00");
+    int hour = numStr.toInt();
+
+    // handle 12 hour to 24 hour conversion
+    if (isPM && hour != 12) {
+        hour += 12;  // 2pm becomes 14
+    } else if (!isPM && hour == 12) {
+        hour = 0;  // 12am is actually 0 (midnight)
+    }
+
+    if (hour >= 8 && hour <= 21) {
+        return hour - 8;
+    }
+
+    return -1; // time not in range
+}
+
+int TimetableEngine::dayIndex(const QString &day)
+{
+    static const char *const dayNames[DayCount] = {
+        "Monday", "Tuesday", "Wednesday", "Thursday",
+        "Friday", "Saturday", "Sunday"
+    };
+
+    for (int d = 0; d < DayCount; ++d) {
+        if (day == QLatin1String(dayNames[d])) return d;
+    }
+    return -1;
+}
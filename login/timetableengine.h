@@ -0,0 +1,297 @@
+/**
+ * TimetableEngine Header File
+ *
+ * This file defines the scheduling engine behind the TIMETABLE window.
+ * It turns the flat course list into course groups (one group per course
+ * name, one option per section) and answers questions about the
+ * conflict-free timetables that can be built from them.
+ */
+
+#ifndef TIMETABLEENGINE_H
+#define TIMETABLEENGINE_H
+
+#include <QVector>
+#include <QString>
+#include <QHash>
+#include <QSharedPointer>
+#include <QElapsedTimer>
+
+struct Course;  // Forward declaration
+class MemoSpill;
+
+/**
+ * Schedule Constraints
+ *
+ * Time-window limits applied to every section before counting.
+ * Times use the same 12-hour strings as Course ("9am"); empty = no limit.
+ * Per-section locks and exclusions live on Course::preference.
+ */
+struct ScheduleConstraints {
+    QString earliestStart;  // Never start before this time
+    QString latestEnd;      // Never end after this time
+};
+
+/**
+ * Prune Report
+ *
+ * How many sections each constraint removed, and how much that shrank
+ * the raw search space (product of section counts per course).
+ */
+struct PruneReport {
+    int excludedSections = 0;    // Removed because they were excluded
+    int lockedOutSections = 0;   // Removed because another section of the course is locked
+    int outsideTimeWindow = 0;   // Removed by the earliest start / latest end window
+    int emptyGroups = 0;         // Courses left with no section at all
+    quint64 searchSpaceBefore = 0;
+    quint64 searchSpaceAfter = 0;
+};
+
+/**
+ * Generation Limits
+ *
+ * Bounds on the first count after setCourses(); 0 = no limit.
+ * When a limit is hit, the engine still lists a consistent, conflict-free
+ * subset of the timetables and reports that it is truncated.
+ */
+struct GenerationLimits {
+    quint64 maxResults = 0;  // List at most this many pages
+    quint64 maxNodes = 0;    // Stop counting after this many DP states
+    qint64 deadlineMs = 0;   // Stop counting after this much wall-clock time
+};
+
+/**
+ * TimetableEngine Class
+ *
+ * Counts conflict-free timetables without enumerating them.
+ *
+ * Every section occupies a single day, so a week is stored as seven
+ * 16-bit hour masks (bit 0 = 8am ... bit 13 = 9pm). The number of
+ * conflict-free timetables is computed by dynamic programming over
+ * (group index, occupancy) states. Only the days that later groups can
+ * still touch are kept in the memo key, because the remaining choices
+ * are independent of every other day.
+ *
+ * Sections of one course that produce an identical weekly grid (same
+ * day and hours, different classroom) are collapsed into a single
+ * section with several variants. Two timetables then share a page
+ * exactly when their canonical day/hour -> course grids are equal.
+ *
+ * Counts saturate at the largest quint64 instead of overflowing.
+ *
+ * The memo is kept within a memory budget. When it outgrows the budget,
+ * its entries move to a memory-mapped temporary file (MemoSpill) and
+ * are read back from there on later lookups, so even huge course sets
+ * stay browsable with bounded memory.
+ */
+class TimetableEngine {
+public:
+    static const int DayCount = 7;
+    static const int HourCount = 14;  // 8am to 9pm
+
+    TimetableEngine();
+
+    /**
+     * Rebuilds the course groups and drops all memoized counts
+     * Locks, exclusions and the time window are applied here as domain
+     * filters, so pruned sections never reach the counting step.
+     * @param courses: All courses added by the user
+     * @param constraints: Optional time window
+     */
+    void setCourses(const QVector<Course> &courses,
+                    const ScheduleConstraints &constraints = ScheduleConstraints());
+
+    /**
+     * What the last setCourses() call pruned, per constraint
+     */
+    const PruneReport &pruneReport() const;
+
+    /**
+     * Number of course groups (distinct course names)
+     */
+    int groupCount() const;
+
+    /**
+     * Limits for the next count; call after setCourses(), before validCount()
+     */
+    void setLimits(const GenerationLimits &newLimits);
+
+    /**
+     * Number of conflict-free timetables (one section per group)
+     * Counted once, then cached. With limits, this is the number of pages
+     * that can be browsed, which may be fewer than exist.
+     */
+    quint64 validCount();
+
+    /**
+     * True if a limit stopped the count or capped the page count
+     */
+    bool isTruncated();
+
+    /**
+     * Total number of conflict-free timetables: exact unless counting was
+     * stopped early, else a Knuth random-probe estimate (never below
+     * validCount())
+     */
+    quint64 estimatedTotal();
+
+    /**
+     * Unranking: returns the section chosen in each group for the
+     * conflict-free timetable at the given page index, without visiting
+     * any earlier page. Costs O(groups x sections) memo lookups.
+     * Pages follow the same order as the old recursive generator.
+     * @param index: 0-based page index, must be below validCount()
+     * @return one section index per group, or empty if index is out of range
+     */
+    QVector<int> choicesAt(quint64 index);
+
+    /**
+     * Returns the conflict-free timetable at the given page index
+     * @param index: 0-based page index, must be below validCount()
+     */
+    QVector<Course> combinationAt(quint64 index);
+
+    /**
+     * Expands per-group section choices (from choicesAt) into courses
+     * A collapsed section lists all of its classrooms, e.g. "Lab 1 / Lab 2"
+     */
+    QVector<Course> combinationFromChoices(const QVector<int> &choices) const;
+
+    /**
+     * Number of original timetables shown on one page (product of variants)
+     */
+    quint64 variantCount(const QVector<int> &choices) const;
+
+    /**
+     * Number of sections folded into another section with the same grid
+     */
+    int collapsedSectionCount() const;
+
+    /**
+     * Ranking (inverse of choicesAt): page index of a conflict-free choice
+     * @return the page index, or validCount() if the choices conflict
+     */
+    quint64 rankOf(const QVector<int> &choices);
+
+    /**
+     * Read-only access to the compact sections, for search code that
+     * works on section choices directly (e.g. TimetableOptimizer)
+     */
+    int sectionCount(int groupIndex) const;
+    int sectionDay(int groupIndex, int sectionIndex) const;
+    quint16 sectionMask(int groupIndex, int sectionIndex) const;
+
+    /**
+     * Memoized counts, for saving next to the course set they came from
+     * restoreMemo() only accepts data saved for the same sections
+     * (checked with layoutFingerprint()) and is meant to be called right
+     * after setCourses(), before anything is counted.
+     */
+    QByteArray saveMemo() const;
+    bool restoreMemo(const QByteArray &data);
+    int memoSize() const;
+    quint64 layoutFingerprint() const;
+
+    /**
+     * Memory the in-RAM memo may use before it spills to disk
+     * The default applies to engines created afterwards (see main.cpp)
+     */
+    void setMemoryBudget(qint64 bytes);
+    static void setDefaultMemoryBudget(qint64 bytes);
+
+    /**
+     * Memo entries kept on disk, and the size of their file
+     */
+    int spilledEntries() const;
+    qint64 spillFileBytes() const;
+
+    /**
+     * Moves every in-RAM count to the spill file. Call it before copying
+     * the engine: the copy then reads the counts from the shared file
+     * instead of holding a second in-RAM memo. Copies never write into a
+     * file they share; what they count themselves goes to their own.
+     */
+    void spillToDisk();
+
+    /**
+     * Converts a time string ("8am", "2pm") to an hour column, -1 if out of range
+     */
+    static int hourIndex(const QString &time);
+
+    /**
+     * Converts a day name ("Monday") to a day row, -1 if unknown
+     */
+    static int dayIndex(const QString &day);
+
+private:
+    /**
+     * One section of a course in compact form
+     * mask is 0 when the time range is invalid (the section never conflicts)
+     */
+    struct Section {
+        QVector<int> variants;  // Indexes into sourceCourses with this exact grid
+        int day;
+        quint16 mask;
+    };
+
+    /**
+     * Week occupancy: one hour mask per day
+     */
+    struct Occupancy {
+        quint16 day[DayCount];
+    };
+
+    /**
+     * Memo key: group index plus the relevant part of the occupancy,
+     * packed into 128 bits (14 hours x 7 days = 98 bits)
+     */
+    struct StateKey {
+        quint64 low;
+        quint64 high;
+        bool operator==(const StateKey &other) const {
+            return low == other.low && high == other.high;
+        }
+        friend size_t qHash(const StateKey &key, size_t seed = 0) {
+            return qHashMulti(seed, key.low, key.high);
+        }
+    };
+
+    /**
+     * This engine's spill file, plus read-only references to the files of
+     * the engine it was copied from (a copy starts without a file of its own)
+     */
+    struct SpillFiles {
+        QSharedPointer<MemoSpill> own;
+        QVector<QSharedPointer<const MemoSpill>> shared;
+
+        SpillFiles() = default;
+        SpillFiles(const SpillFiles &other);
+        SpillFiles &operator=(const SpillFiles &other);
+
+        bool find(quint64 low, quint64 high, quint64 &count) const;
+    };
+
+    quint64 countFrom(int groupIndex, const Occupancy &occupancy);
+    StateKey makeKey(int groupIndex, const Occupancy &occupancy) const;
+    void spillMemo();
+
+    QVector<Course> sourceCourses;        // Deduplicated courses
+    QVector<QVector<Section>> groups;     // Sections of each course group
+    QVector<quint8> remainingDays;        // Days touched by groups[g..], as a bitmask
+    QHash<StateKey, quint64> memo;        // Memoized subtree counts
+    SpillFiles spill;                     // Entries beyond the budget
+    int memoBudgetEntries;                // memo.size() that triggers a spill
+    bool spillFailed;                     // Don't retry a spill file that can't be made
+
+    // Counting under limits: once a limit is hit, unvisited states count as
+    // 0 and partial counts are memoized, so paging stays consistent
+    GenerationLimits limits;
+    bool counted;                         // fullCount is valid
+    quint64 fullCount;                    // Count from group 0 (before maxResults)
+    bool limitHit;                        // maxNodes or the deadline stopped counting
+    quint64 nodeCount;
+    QElapsedTimer countTimer;
+    int collapsedSections;                // Sections merged as grid duplicates
+    PruneReport report;                   // Constraint pruning statistics
+};
+
+#endif // TIMETABLEENGINE_H
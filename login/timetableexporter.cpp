@@ -0,0 +1,147 @@
+/**
+ * TimetableExporter Implementation File
+ *
+ * Implements batched, streaming export of timetable pages.
+ */
+
+#include "timetableexporter.h"
+#include "timetablerenderer.h"
+#include "managecoursespage.h"
+#include "tracer.h"
+#include <QFileInfo>
+#include <QDir>
+#include <QPdfWriter>
+#include <QPainter>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtConcurrent/QtConcurrentMap>
+
+namespace {
+
+// pages held in memory at once; bounds memory use for any page count
+const int BatchSize = 32;
+
+// one page waiting to be rendered
+struct PageJob {
+    QVector<Course> courses;
+    QString fileName;
+    bool saved = false;
+};
+
+} // namespace
+
+TimetableExporter::TimetableExporter(const TimetableEngine &engine, quint64 pageCount,
+                                     const QString &fileName, qreal dpi)
+    : QObject(nullptr)
+    , engine(engine)
+    , pageCount(pageCount)
+    , fileName(fileName)
+    , dpi(dpi)
+    , cancelled(0)
+{
+}
+
+// The exporter deletes itself once the worker is done, so it outlives
+// the window that started it if that window is closed mid-export
+void TimetableExporter::start()
+{
+    connect(this, &TimetableExporter::finished, this, &QObject::deleteLater);
+    QtConcurrent::run([this]() { run(); });
+}
+
+void TimetableExporter::cancel()
+{
+    cancelled.storeRelaxed(1);
+}
+
+// Worker thread entry point; signals are delivered queued to the GUI thread
+void TimetableExporter::run()
+{
+    quint64 pagesWritten = 0;
+    QString errorMessage;
+
+    bool success = fileName.endsWith(".pdf", Qt::CaseInsensitive)
+                       ? exportPdf(pagesWritten, errorMessage)
+                       : exportImages(pagesWritten, errorMessage);
+
+    emit finished(success, pagesWritten, errorMessage);
+}
+
+// PDF pages are painted in order into one writer; vector drawing is cheap
+// and QPdfWriter writes each finished page out, so nothing accumulates
+bool TimetableExporter::exportPdf(quint64 &pagesWritten, QString &errorMessage)
+{
+    QPdfWriter writer(fileName);
+    TimetableRenderer::preparePdfWriter(writer);
+    writer.setTitle("Timetables");
+
+    QPainter painter;
+    if (!painter.begin(&writer)) {
+        errorMessage = QString("Cannot write to %1").arg(fileName);
+        return false;
+    }
+
+    for (quint64 page = 0; page < pageCount; ++page) {
+        if (cancelled.loadRelaxed()) break;
+
+        TRACE_SCOPE("worker", "export page");
+        if (page > 0) writer.newPage();
+        TimetableRenderer::paint(painter, engine.combinationAt(page));
+        pagesWritten++;
+
+        if (pagesWritten % BatchSize == 0 || pagesWritten == pageCount) {
+            emit progress(pagesWritten, pageCount);
+        }
+    }
+
+    painter.end();
+    return !cancelled.loadRelaxed();
+}
+
+// Images are rendered a batch at a time in parallel; each worker saves
+// its own image straight away, so at most one batch of pages is in memory
+bool TimetableExporter::exportImages(quint64 &pagesWritten, QString &errorMessage)
+{
+    const qreal imageDpi = dpi;
+
+    for (quint64 first = 0; first < pageCount; first += BatchSize) {
+        if (cancelled.loadRelaxed()) return false;
+
+        // Unranking uses the engine memo, so it stays on this one thread
+        QVector<PageJob> batch;
+        for (quint64 page = first; page < pageCount && page < first + BatchSize; ++page) {
+            PageJob job;
+            job.courses = engine.combinationAt(page);
+            job.fileName = imageFileName(page);
+            batch.append(job);
+        }
+
+        QtConcurrent::blockingMap(&renderPool, batch, [imageDpi](PageJob &job) {
+            TRACE_SCOPE("worker", "export page");
+            job.saved = TimetableRenderer::renderImage(job.courses, imageDpi).save(job.fileName);
+        });
+
+        for (const PageJob &job : batch) {
+            if (!job.saved) {
+                errorMessage = QString("Cannot write %1").arg(job.fileName);
+                return false;
+            }
+            pagesWritten++;
+        }
+
+        emit progress(pagesWritten, pageCount);
+    }
+
+    return true;
+}
+
+// "dir/timetable.png" -> "dir/timetable_0042.png", padded to the widest page number
+QString TimetableExporter::imageFileName(quint64 page) const
+{
+    QFileInfo info(fileName);
+    const int digits = QString::number(pageCount).size();
+
+    return info.dir().filePath(QString("%1_%2.%3")
+                                   .arg(info.completeBaseName())
+                                   .arg(page + 1, digits, 10, QChar('0'))
+                                   .arg(info.suffix().isEmpty() ? "png" : info.suffix()));
+}
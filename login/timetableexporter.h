@@ -0,0 +1,73 @@
+/**
+ * TimetableExporter Header File
+ *
+ * This file defines the bulk exporter that writes many timetable pages
+ * in one pass, either into one multi-page PDF or into numbered images.
+ */
+
+#ifndef TIMETABLEEXPORTER_H
+#define TIMETABLEEXPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include "timetableengine.h"
+
+/**
+ * TimetableExporter Class
+ *
+ * Runs on a worker thread and streams pages to disk in small batches, so
+ * memory use stays flat no matter how many pages are exported:
+ * - PDF: pages are painted one after another into a single QPdfWriter
+ * - PNG/JPEG: each batch is rendered in parallel on a private thread pool
+ *   and every image is saved as soon as it is drawn
+ *
+ * The exporter keeps its own copy of the engine, so the TIMETABLE window
+ * can keep paging while an export is running. Call spillToDisk() on the
+ * engine first, so the copy shares its counts instead of duplicating them.
+ */
+class TimetableExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param engine: Engine holding the pages to export (copied)
+     * @param pageCount: Export pages 0 .. pageCount-1
+     * @param fileName: "x.pdf" for one PDF, "x.png"/"x.jpg" for x_0001.png, x_0002.png, ...
+     * @param dpi: Resolution for image output
+     */
+    TimetableExporter(const TimetableEngine &engine, quint64 pageCount,
+                      const QString &fileName, qreal dpi);
+
+    /**
+     * Starts exporting on a worker thread; returns immediately
+     * The exporter deletes itself after emitting finished()
+     */
+    void start();
+
+    /**
+     * Asks the worker to stop after the current batch
+     */
+    void cancel();
+
+signals:
+    void progress(quint64 pagesDone, quint64 pageCount);
+    void finished(bool success, quint64 pagesWritten, const QString &errorMessage);
+
+private:
+    void run();
+    bool exportPdf(quint64 &pagesWritten, QString &errorMessage);
+    bool exportImages(quint64 &pagesWritten, QString &errorMessage);
+    QString imageFileName(quint64 page) const;
+
+    TimetableEngine engine;
+    quint64 pageCount;
+    QString fileName;
+    qreal dpi;
+    QAtomicInt cancelled;
+    QThreadPool renderPool;  // Parallel image rendering, separate from the worker
+};
+
+#endif // TIMETABLEEXPORTER_H
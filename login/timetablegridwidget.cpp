@@ -0,0 +1,67 @@
+/**
+ * TimetableGridWidget Implementation File
+ */
+
+#include "timetablegridwidget.h"
+#include "managecoursespage.h"
+#include "tracer.h"
+#include <QPainter>
+
+TimetableGridWidget::TimetableGridWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    // every pixel is painted in paintEvent, nothing to erase first
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void TimetableGridWidget::setCourses(const QVector<Course> &courses)
+{
+    TimetableRenderer::layoutBlocks(courses, blocks);
+    pagePixmap = QPixmap();
+    update();
+}
+
+void TimetableGridWidget::setPage(const QVector<TimetableRenderer::Block> &pageBlocks, const QPixmap &rendered)
+{
+    blocks = pageBlocks;  // shared, no copy
+    pagePixmap = rendered;
+    update();
+}
+
+QPixmap TimetableGridWidget::renderPage(const QVector<TimetableRenderer::Block> &pageBlocks) const
+{
+    // full device resolution, so the copy is as sharp as painting directly
+    const qreal ratio = devicePixelRatioF();
+    QPixmap pixmap(size() * ratio);
+    pixmap.setDevicePixelRatio(ratio);
+
+    QPainter painter(&pixmap);
+    TimetableRenderer::paintBlocks(painter, pageBlocks, size());
+    painter.end();
+
+    return pixmap;
+}
+
+bool TimetableGridWidget::fitsWidget(const QPixmap &rendered) const
+{
+    return !rendered.isNull() &&
+           rendered.devicePixelRatio() == devicePixelRatioF() &&
+           rendered.deviceIndependentSize().toSize() == size();
+}
+
+QSize TimetableGridWidget::sizeHint() const
+{
+    return TimetableRenderer::gridSize();
+}
+
+void TimetableGridWidget::paintEvent(QPaintEvent *)
+{
+    TRACE_SCOPE("paint", "grid paint");
+    QPainter painter(this);
+
+    if (fitsWidget(pagePixmap)) {
+        painter.drawPixmap(0, 0, pagePixmap);
+        return;
+    }
+    TimetableRenderer::paintBlocks(painter, blocks, size());
+}
@@ -0,0 +1,71 @@
+/**
+ * TimetableGridWidget Header File
+ *
+ * This file defines the widget that shows one timetable page in the
+ * TIMETABLE window.
+ */
+
+#ifndef TIMETABLEGRIDWIDGET_H
+#define TIMETABLEGRIDWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+#include <QPixmap>
+#include "timetablerenderer.h"
+
+struct Course;  // Forward declaration
+
+/**
+ * TimetableGridWidget Class
+ *
+ * Paints the day rows and hour columns in a single paintEvent from a
+ * compact list of blocks (day, first hour, last hour, text). There are no
+ * per-cell items or spans to create, clear or keep in sync, so changing
+ * page is one layout pass plus one repaint. A page laid out and rendered
+ * earlier (see setPage()) is shown without any layout or allocation: its
+ * blocks and picture are implicitly shared, not copied.
+ *
+ * Drawing is shared with TimetableRenderer, so saved files look exactly
+ * like the window.
+ */
+class TimetableGridWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TimetableGridWidget(QWidget *parent = nullptr);
+
+    /**
+     * Shows a new page; schedules one repaint
+     */
+    void setCourses(const QVector<Course> &courses);
+
+    /**
+     * Shows a page that was laid out with TimetableRenderer::layoutBlocks()
+     * and rendered with renderPage()
+     * The picture is copied to the screen as is; if the widget has been
+     * resized since, the blocks are painted instead
+     */
+    void setPage(const QVector<TimetableRenderer::Block> &pageBlocks, const QPixmap &rendered);
+
+    /**
+     * Renders laid-out blocks at the widget's current size, for showing later
+     */
+    QPixmap renderPage(const QVector<TimetableRenderer::Block> &pageBlocks) const;
+
+    /**
+     * true if a picture from renderPage() still fits the widget
+     */
+    bool fitsWidget(const QPixmap &rendered) const;
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QVector<TimetableRenderer::Block> blocks;  // Own layout, or shared with a cached page
+    QPixmap pagePixmap;  // Pre-rendered page, null if none
+};
+
+#endif // TIMETABLEGRIDWIDGET_H
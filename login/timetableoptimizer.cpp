@@ -0,0 +1,240 @@
+/**
+ * TimetableOptimizer Implementation File
+ *
+ * Implements scoring and the simulated annealing loop.
+ */
+
+#include "timetableoptimizer.h"
+#include "timetableengine.h"
+#include "perfmetrics.h"
+#include "tracer.h"
+#include <QElapsedTimer>
+#include <QtAlgorithms>
+#include <cmath>
+
+namespace {
+
+// cost weights - one conflict is worse than any amount of idle time.
+// Class hours only break ties between sections of different lengths; a
+// full week (98 hours, 84 gap hours, 7 days) still costs under 1000.
+const qint64 ConflictWeight = 1000;
+const qint64 GapWeight = 10;
+const qint64 DayWeight = 4;
+const qint64 HourWeight = 1;
+
+// annealing schedule
+const double InitialTemperature = 50.0;
+const double MinTemperature = 0.5;
+const double CoolingRate = 0.9995;
+const quint64 ReheatAfter = 20000;     // steps without a new best before reheating
+const quint64 SettledAfter = 200000;   // steps without a new best before giving up
+const int StepsPerTimeCheck = 256;
+
+} // namespace
+
+qint64 OptimizerScore::cost() const
+{
+    return conflicts * ConflictWeight + gapHours * GapWeight + activeDays * DayWeight +
+           totalHours * HourWeight;
+}
+
+TimetableOptimizer::TimetableOptimizer()
+    : temperature(InitialTemperature)
+    , iterationCount(0)
+    , lastImprovement(0)
+    , resumedSettled(false)
+    , random(1)  // fixed seed so the same courses give the same answer
+{
+}
+
+void TimetableOptimizer::setProblem(const TimetableEngine &engine)
+{
+    groups.clear();
+    movableGroups.clear();
+    current.clear();
+    best.clear();
+    currentScore = OptimizerScore();
+    bestFound = OptimizerScore();
+    temperature = InitialTemperature;
+    iterationCount = 0;
+    lastImprovement = 0;
+    resumedSettled = false;
+    random.seed(1);
+
+    bool solvable = engine.groupCount() > 0;
+    for (int g = 0; g < engine.groupCount(); ++g) {
+        QVector<Slot> group;
+        for (int s = 0; s < engine.sectionCount(g); ++s) {
+            group.append({ engine.sectionDay(g, s), engine.sectionMask(g, s) });
+        }
+        if (group.isEmpty()) solvable = false;
+        if (group.size() > 1) movableGroups.append(g);
+        groups.append(group);
+    }
+
+    if (!solvable) return;
+
+    // Greedy first answer: the first section that fits, else the first one
+    quint16 occupancy[TimetableEngine::DayCount] = {};
+    for (const QVector<Slot> &group : groups) {
+        int pick = 0;
+        for (int s = 0; s < group.size(); ++s) {
+            if (!(occupancy[group[s].day] & group[s].mask)) {
+                pick = s;
+                break;
+            }
+        }
+        occupancy[group[pick].day] |= group[pick].mask;
+        current.append(pick);
+    }
+
+    currentScore = evaluate(current);
+    best = current;
+    bestFound = currentScore;
+}
+
+void TimetableOptimizer::resumeFrom(const QVector<int> &choices, bool settled)
+{
+    if (!hasResult() || choices.size() != groups.size()) return;
+    for (int g = 0; g < groups.size(); ++g) {
+        if (choices[g] < 0 || choices[g] >= groups[g].size()) return;
+    }
+
+    OptimizerScore score = evaluate(choices);
+    if (score.cost() > bestFound.cost()) return;
+
+    current = choices;
+    currentScore = score;
+    best = choices;
+    bestFound = score;
+    resumedSettled = settled;
+}
+
+void TimetableOptimizer::run(int budgetMs)
+{
+    if (isSettled()) return;
+    METRICS_SCOPE(Metric::OptimizerRun);
+    TRACE_SCOPE("engine", "optimizer run");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // check the clock every few hundred steps, not on every step
+    do {
+        for (int i = 0; i < StepsPerTimeCheck; ++i) {
+            step();
+        }
+    } while (timer.elapsed() < budgetMs && !isSettled());
+}
+
+// One annealing move: switch one course to a different section
+void TimetableOptimizer::step()
+{
+    iterationCount++;
+
+    int g = movableGroups[random.bounded(int(movableGroups.size()))];
+    int oldSection = current[g];
+
+    // pick any other section of the same course
+    int newSection = random.bounded(int(groups[g].size()) - 1);
+    if (newSection >= oldSection) newSection++;
+
+    current[g] = newSection;
+    OptimizerScore candidate = evaluate(current);
+    qint64 delta = candidate.cost() - currentScore.cost();
+
+    if (delta <= 0 || random.generateDouble() < std::exp(-double(delta) / temperature)) {
+        currentScore = candidate;
+        if (candidate.cost() < bestFound.cost()) {
+            best = current;
+            bestFound = candidate;
+            lastImprovement = iterationCount;
+        }
+    } else {
+        current[g] = oldSection;  // undo the move
+    }
+
+    temperature = qMax(MinTemperature, temperature * CoolingRate);
+
+    // stuck for a while: continue from the best answer with a hot search
+    if (iterationCount - lastImprovement > 0 &&
+        (iterationCount - lastImprovement) % ReheatAfter == 0) {
+        current = best;
+        currentScore = bestFound;
+        temperature = InitialTemperature;
+    }
+}
+
+// Full evaluation - timetables are small (tens of courses), so this is
+// cheap enough to run thousands of times per slice
+OptimizerScore TimetableOptimizer::evaluate(const QVector<int> &choices) const
+{
+    OptimizerScore score;
+    quint16 dayMasks[TimetableEngine::DayCount] = {};
+
+    for (int i = 0; i < groups.size(); ++i) {
+        const Slot &a = groups[i][choices[i]];
+        score.totalHours += qPopulationCount(a.mask);
+        dayMasks[a.day] |= a.mask;
+
+        // Check every later course on the same day for overlap
+        for (int j = i + 1; j < groups.size(); ++j) {
+            const Slot &b = groups[j][choices[j]];
+            if (a.day == b.day && (a.mask & b.mask)) {
+                score.conflicts++;
+            }
+        }
+    }
+
+    for (quint16 mask : dayMasks) {
+        if (!mask) continue;
+
+        // span from the first to the last busy hour, minus the busy hours
+        int first = qCountTrailingZeroBits(mask);
+        int last = 15 - qCountLeadingZeroBits(mask);
+        score.gapHours += (last - first + 1) - qPopulationCount(mask);
+        score.activeDays++;
+    }
+
+    return score;
+}
+
+bool TimetableOptimizer::hasResult() const
+{
+    return !best.isEmpty();
+}
+
+bool TimetableOptimizer::hasConflictFreeResult() const
+{
+    return hasResult() && bestFound.conflicts == 0;
+}
+
+bool TimetableOptimizer::isSettled() const
+{
+    return !hasResult() || movableGroups.isEmpty() || resumedSettled ||
+           iterationCount - lastImprovement >= SettledAfter;
+}
+
+OptimizerScore TimetableOptimizer::scoreOf(const QVector<int> &choices) const
+{
+    if (choices.size() != groups.size()) return OptimizerScore();
+    for (int g = 0; g < groups.size(); ++g) {
+        if (choices[g] < 0 || choices[g] >= groups[g].size()) return OptimizerScore();
+    }
+    return evaluate(choices);
+}
+
+QVector<int> TimetableOptimizer::bestChoices() const
+{
+    return best;
+}
+
+OptimizerScore TimetableOptimizer::bestScore() const
+{
+    return bestFound;
+}
+
+quint64 TimetableOptimizer::iterations() const
+{
+    return iterationCount;
+}
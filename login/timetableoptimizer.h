@@ -0,0 +1,118 @@
+/**
+ * TimetableOptimizer Header File
+ *
+ * This file defines an anytime local-search optimizer that looks for a
+ * good timetable when there are far too many pages to browse by hand.
+ */
+
+#ifndef TIMETABLEOPTIMIZER_H
+#define TIMETABLEOPTIMIZER_H
+
+#include <QVector>
+#include <QRandomGenerator>
+
+class TimetableEngine;
+
+/**
+ * Optimizer Score
+ *
+ * Uses the same numbers as the TIMETABLE statistics bar (conflicts and
+ * total hours) plus two compactness measures. Lower cost is better.
+ */
+struct OptimizerScore {
+    int conflicts = 0;    // Overlapping section pairs, counted like detectConflicts()
+    int totalHours = 0;   // Counted like calculateTotalHours()
+    int gapHours = 0;     // Idle hours between the first and last class of each day
+    int activeDays = 0;   // Days with at least one class
+
+    /**
+     * Single number to minimise: any conflict outweighs all other terms;
+     * then idle hours, active days and, weighted least, total hours
+     */
+    qint64 cost() const;
+};
+
+/**
+ * TimetableOptimizer Class
+ *
+ * Simulated annealing over the section chosen for each course group.
+ * A move switches one course to another of its sections; worse moves are
+ * accepted with a probability that shrinks as the temperature cools, and
+ * the search reheats from the best answer when it stops improving.
+ *
+ * The optimizer is "anytime": run() can be called repeatedly with small
+ * time budgets and bestChoices() always holds the best answer so far.
+ */
+class TimetableOptimizer {
+public:
+    TimetableOptimizer();
+
+    /**
+     * Copies the compact sections out of the engine and restarts the search
+     * from a greedy first answer
+     */
+    void setProblem(const TimetableEngine &engine);
+
+    /**
+     * Continues from an answer found in an earlier session (same problem)
+     * The answer is only taken if it beats the current best.
+     * @param settled: true if that search had already finished
+     */
+    void resumeFrom(const QVector<int> &choices, bool settled);
+
+    /**
+     * Keeps improving the answer until the time budget is used up
+     * @param budgetMs: Wall-clock budget in milliseconds
+     */
+    void run(int budgetMs);
+
+    /**
+     * True once an answer exists (every course has at least one section)
+     */
+    bool hasResult() const;
+
+    /**
+     * True if the best answer so far has no conflicts
+     */
+    bool hasConflictFreeResult() const;
+
+    /**
+     * True when more searching is unlikely to help: nothing can move, or
+     * the best answer has not changed for a long time
+     */
+    bool isSettled() const;
+
+    /**
+     * Scores any choice of sections of the current problem (one per group)
+     */
+    OptimizerScore scoreOf(const QVector<int> &choices) const;
+
+    QVector<int> bestChoices() const;
+    OptimizerScore bestScore() const;
+    quint64 iterations() const;
+
+private:
+    struct Slot {
+        int day;
+        quint16 mask;
+    };
+
+    OptimizerScore evaluate(const QVector<int> &choices) const;
+    void step();
+
+    QVector<QVector<Slot>> groups;  // Sections of each course group
+    QVector<int> movableGroups;     // Groups with more than one section
+
+    QVector<int> current;
+    OptimizerScore currentScore;
+    QVector<int> best;
+    OptimizerScore bestFound;
+
+    double temperature;
+    quint64 iterationCount;
+    quint64 lastImprovement;  // Iteration at which best last changed
+    bool resumedSettled;      // Finished in an earlier session, don't search again
+    QRandomGenerator random;
+};
+
+#endif // TIMETABLEOPTIMIZER_H
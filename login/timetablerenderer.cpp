@@ -0,0 +1,219 @@
+/**
+ * TimetableRenderer Implementation File
+ *
+ * Paints the timetable grid with QPainter (dark blue theme of the
+ * TIMETABLE window) into the on-screen grid widget, raster images, PDF
+ * pages or SVG files.
+ */
+
+#include "timetablerenderer.h"
+#include "timetableengine.h"
+#include "managecoursespage.h"
+#include <QPainter>
+#include <QColor>
+#include <QFont>
+#include <QPdfWriter>
+#include <QPageSize>
+#include <QSvgGenerator>
+
+namespace {
+
+// layout in logical pixels (96 dpi)
+const int RowHeaderWidth = 110;
+const int HeaderHeight = 40;
+const int ColumnWidth = 100;  // default size only, paint() stretches columns
+const int RowHeight = 80;
+const int ColumnCount = 15;  // 8am to 10pm
+
+const char *const DayNames[TimetableEngine::DayCount] = {
+    "Monday", "Tuesday", "Wednesday", "Thursday",
+    "Friday", "Saturday", "Sunday"
+};
+
+// same text as the table header in timetable.ui
+QString columnTitle(int column)
+{
+    int hour = column + 8;
+    if (hour < 12) return QString("%1.00am").arg(hour);
+    if (hour == 12) return QString("12.00am");
+    return QString("%1.00pm").arg(hour - 12);
+}
+
+} // namespace
+
+QSize TimetableRenderer::gridSize()
+{
+    return QSize(RowHeaderWidth + ColumnCount * ColumnWidth,
+                 HeaderHeight + TimetableEngine::DayCount * RowHeight);
+}
+
+void TimetableRenderer::layoutBlocks(const QVector<Course> &courses, QVector<Block> &blocks)
+{
+    blocks.clear();
+    blocks.reserve(courses.size());
+
+    for (const Course &course : courses) {
+        int row = TimetableEngine::dayIndex(course.day);
+        int startCol = TimetableEngine::hourIndex(course.startTime);
+        int endCol = TimetableEngine::hourIndex(course.endTime);
+
+        if (row < 0 || startCol < 0 || endCol < 0) continue;
+        if (startCol >= endCol) continue; // Invalid time range
+
+        blocks.append({ row, startCol, endCol,
+                        QString("%1\n%2\n%3-%4")
+                            .arg(course.name)
+                            .arg(course.classroom)
+                            .arg(course.startTime)
+                            .arg(course.endTime) });
+    }
+}
+
+void TimetableRenderer::paint(QPainter &painter, const QVector<Course> &courses, const QSize &size)
+{
+    QVector<Block> blocks;
+    layoutBlocks(courses, blocks);
+    paintBlocks(painter, blocks, size);
+}
+
+void TimetableRenderer::paintBlocks(QPainter &painter, const QVector<Block> &blocks, const QSize &size)
+{
+    const QColor backgroundColor("#0D1B2A");
+    const QColor headerColor("#253445");
+    const QColor cellColor("#1a2535");
+    const QColor lineColor("#2d5a8c");
+    const QColor courseColor("#2d5a8c");
+    const QColor textColor("#FFFFFF");
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setRenderHint(QPainter::TextAntialiasing, true);
+
+    painter.fillRect(QRect(QPoint(0, 0), size), backgroundColor);
+
+    // Hour columns and day rows share whatever space is left after the headers
+    const qreal columnWidth = qreal(size.width() - RowHeaderWidth) / ColumnCount;
+    const qreal rowHeight = qreal(size.height() - HeaderHeight) / TimetableEngine::DayCount;
+    auto columnX = [&](int col) { return RowHeaderWidth + qRound(col * columnWidth); };
+    auto rowY = [&](int row) { return HeaderHeight + qRound(row * rowHeight); };
+
+    // Pixel-sized fonts scale with the painter, point sizes would not
+    QFont headerFont;
+    headerFont.setBold(true);
+    headerFont.setPixelSize(13);
+
+    QFont courseFont;
+    courseFont.setBold(true);
+    courseFont.setPixelSize(11);
+
+    // Header row and day column
+    painter.setFont(headerFont);
+    painter.fillRect(0, 0, size.width(), HeaderHeight, headerColor);
+    painter.fillRect(0, HeaderHeight, RowHeaderWidth, size.height() - HeaderHeight, headerColor);
+
+    painter.setPen(textColor);
+    for (int col = 0; col < ColumnCount; ++col) {
+        QRect rect(columnX(col), 0, columnX(col + 1) - columnX(col), HeaderHeight);
+        painter.drawText(rect, Qt::AlignCenter, columnTitle(col));
+    }
+    for (int row = 0; row < TimetableEngine::DayCount; ++row) {
+        QRect rect(0, rowY(row), RowHeaderWidth, rowY(row + 1) - rowY(row));
+        painter.drawText(rect, Qt::AlignCenter, DayNames[row]);
+    }
+
+    // Empty cells
+    painter.fillRect(RowHeaderWidth, HeaderHeight,
+                     size.width() - RowHeaderWidth, size.height() - HeaderHeight, cellColor);
+
+    // Grid lines
+    painter.setPen(lineColor);
+    for (int col = 0; col <= ColumnCount; ++col) {
+        int x = columnX(col);
+        painter.drawLine(x, 0, x, size.height());
+    }
+    for (int row = 0; row <= TimetableEngine::DayCount; ++row) {
+        int y = rowY(row);
+        painter.drawLine(0, y, size.width(), y);
+    }
+    painter.drawRect(0, 0, size.width() - 1, size.height() - 1);
+
+    // One block per course, spanning all of its hours
+    painter.setFont(courseFont);
+    for (const Block &block : blocks) {
+        QRect rect(columnX(block.startColumn), rowY(block.day),
+                   columnX(block.endColumn) - columnX(block.startColumn),
+                   rowY(block.day + 1) - rowY(block.day));
+
+        painter.fillRect(rect, courseColor);
+        painter.setPen(lineColor.lighter(150));
+        painter.drawRect(rect.adjusted(0, 0, -1, -1));
+
+        painter.setPen(textColor);
+        painter.drawText(rect.adjusted(6, 4, -6, -4),
+                         Qt::AlignCenter | Qt::TextWordWrap,
+                         block.text);
+    }
+
+    painter.restore();
+}
+
+QImage TimetableRenderer::renderImage(const QVector<Course> &courses, qreal dpi)
+{
+    const qreal scale = dpi / 96.0;
+    const QSize size = gridSize();
+
+    QImage image(qRound(size.width() * scale), qRound(size.height() * scale),
+                 QImage::Format_ARGB32_Premultiplied);
+    image.fill(QColor("#0D1B2A"));
+
+    // store the resolution in the file so viewers print it at the right size
+    const int dotsPerMeter = qRound(dpi / 0.0254);
+    image.setDotsPerMeterX(dotsPerMeter);
+    image.setDotsPerMeterY(dotsPerMeter);
+
+    QPainter painter(&image);
+    painter.scale(scale, scale);
+    paint(painter, courses);
+    painter.end();
+
+    return image;
+}
+
+void TimetableRenderer::preparePdfWriter(QPdfWriter &writer)
+{
+    const QSize size = gridSize();
+
+    writer.setResolution(96);  // one PDF unit = one logical pixel of the grid
+    writer.setPageSize(QPageSize(QSizeF(size) * 72.0 / 96.0, QPageSize::Point,
+                                 QString(), QPageSize::ExactMatch));
+    writer.setPageMargins(QMarginsF(0, 0, 0, 0));
+}
+
+bool TimetableRenderer::writePdf(const QVector<Course> &courses, const QString &fileName)
+{
+    QPdfWriter writer(fileName);
+    preparePdfWriter(writer);
+    writer.setTitle("Timetable");
+
+    QPainter painter;
+    if (!painter.begin(&writer)) return false;
+    paint(painter, courses);
+    return painter.end();
+}
+
+bool TimetableRenderer::writeSvg(const QVector<Course> &courses, const QString &fileName)
+{
+    const QSize size = gridSize();
+
+    QSvgGenerator generator;
+    generator.setFileName(fileName);
+    generator.setSize(size);
+    generator.setViewBox(QRect(QPoint(0, 0), size));
+    generator.setResolution(96);
+    generator.setTitle("Timetable");
+
+    QPainter painter;
+    if (!painter.begin(&generator)) return false;
+    paint(painter, courses);
+    return painter.end();
+}
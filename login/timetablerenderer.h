@@ -0,0 +1,84 @@
+/**
+ * TimetableRenderer Header File
+ *
+ * This file defines an offscreen renderer that draws a weekly timetable
+ * grid straight from course data, without going through any widget.
+ */
+
+#ifndef TIMETABLERENDERER_H
+#define TIMETABLERENDERER_H
+
+#include <QVector>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+struct Course;  // Forward declaration
+class QPainter;
+class QPdfWriter;
+
+/**
+ * TimetableRenderer Class
+ *
+ * Draws the same grid the TIMETABLE window shows: days as rows, hours as
+ * columns, one dark-blue block per course. Everything is laid out in
+ * logical pixels (96 dpi) and scaled, so any resolution looks the same.
+ *
+ * Only QPainter and QImage are used, so rendering is safe on a worker
+ * thread (e.g. through QtConcurrent::run).
+ */
+class TimetableRenderer {
+public:
+    /**
+     * One course laid out on the grid: a day row and a span of hour
+     * columns, with its cell text prepared once
+     */
+    struct Block {
+        int day;
+        int startColumn;
+        int endColumn;  // exclusive
+        QString text;
+    };
+
+    /**
+     * Size of the full grid (all 7 days, all hour columns) at 96 dpi
+     */
+    static QSize gridSize();
+
+    /**
+     * Converts courses into blocks, skipping invalid days/times
+     * Reuses the capacity of blocks, so repeated layouts don't reallocate
+     */
+    static void layoutBlocks(const QVector<Course> &courses, QVector<Block> &blocks);
+
+    /**
+     * Paints the grid into the painter at its current transform, with
+     * the top-left corner at (0, 0). Columns and rows stretch to fill size.
+     */
+    static void paint(QPainter &painter, const QVector<Course> &courses,
+                      const QSize &size = gridSize());
+    static void paintBlocks(QPainter &painter, const QVector<Block> &blocks,
+                            const QSize &size = gridSize());
+
+    /**
+     * Renders the grid into a new image
+     * @param courses: Courses on this timetable page
+     * @param dpi: Output resolution, 96 = same size as on screen
+     */
+    static QImage renderImage(const QVector<Course> &courses, qreal dpi = 96.0);
+
+    /**
+     * Sets page size, margins and resolution so one PDF page holds
+     * exactly one grid, drawn in the same logical units as paint()
+     */
+    static void preparePdfWriter(QPdfWriter &writer);
+
+    /**
+     * Vector output: small files that stay sharp at any zoom level
+     * @return true if the file was written
+     */
+    static bool writePdf(const QVector<Course> &courses, const QString &fileName);
+    static bool writeSvg(const QVector<Course> &courses, const QString &fileName);
+};
+
+#endif // TIMETABLERENDERER_H
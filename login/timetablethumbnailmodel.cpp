@@ -0,0 +1,144 @@
+/**
+ * TimetableThumbnailModel Implementation File
+ *
+ * Implements lazy, background rendering of timetable thumbnails.
+ */
+
+#include "timetablethumbnailmodel.h"
+#include "timetableengine.h"
+#include "timetablerenderer.h"
+#include "managecoursespage.h"
+#include "tracer.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QColor>
+#include <limits>
+
+namespace {
+
+const qreal ThumbnailDpi = 24.0;      // a quarter of screen size
+const int RowsPerFetch = 200;         // rows added each time the view scrolls to the end
+const int MaxCachedThumbnails = 600;  // finished thumbnails kept in memory
+const int MaxQueuedRenders = 64;      // older requests are dropped when scrolling fast
+
+} // namespace
+
+TimetableThumbnailModel::TimetableThumbnailModel(TimetableEngine *engine, quint64 pageCount, QObject *parent)
+    : QAbstractListModel(parent)
+    , engine(engine)
+    , pageCount(pageCount)
+    , loadedRows(0)
+    , thumbnails(MaxCachedThumbnails)
+    , rendersInFlight(0)
+{
+    placeholder = QPixmap(thumbnailSize());
+    placeholder.fill(QColor("#1a2535"));
+
+    loadedRows = int(qMin<quint64>(pageCount, RowsPerFetch));
+}
+
+TimetableThumbnailModel::~TimetableThumbnailModel()
+{
+    // don't let queued work outlive the model
+    renderPool.clear();
+    renderPool.waitForDone();
+}
+
+QSize TimetableThumbnailModel::thumbnailSize()
+{
+    QSize size = TimetableRenderer::gridSize();
+    return QSize(qRound(size.width() * ThumbnailDpi / 96.0),
+                 qRound(size.height() * ThumbnailDpi / 96.0));
+}
+
+int TimetableThumbnailModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : loadedRows;
+}
+
+bool TimetableThumbnailModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return false;
+    return quint64(loadedRows) < qMin<quint64>(pageCount, std::numeric_limits<int>::max());
+}
+
+void TimetableThumbnailModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid()) return;
+
+    quint64 limit = qMin<quint64>(pageCount, std::numeric_limits<int>::max());
+    int newRows = int(qMin<quint64>(limit - loadedRows, RowsPerFetch));
+    if (newRows <= 0) return;
+
+    beginInsertRows(QModelIndex(), loadedRows, loadedRows + newRows - 1);
+    loadedRows += newRows;
+    endInsertRows();
+}
+
+QVariant TimetableThumbnailModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= loadedRows) return QVariant();
+
+    const int row = index.row();
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString("Page %1").arg(row + 1);
+    case Qt::DecorationRole:
+        // views only ask for visible rows, so only those get rendered
+        if (QPixmap *pixmap = thumbnails.object(row)) {
+            return *pixmap;
+        }
+        requestThumbnail(row);
+        return placeholder;
+    case PageIndexRole:
+        return QVariant::fromValue<quint64>(row);
+    default:
+        return QVariant();
+    }
+}
+
+void TimetableThumbnailModel::requestThumbnail(int row) const
+{
+    if (requested.contains(row)) return;
+
+    requested.insert(row);
+    queue.append(row);
+
+    // Scrolled past: forget the oldest requests, they are off screen by now
+    while (queue.size() > MaxQueuedRenders) {
+        requested.remove(queue.takeFirst());
+    }
+
+    startRenders();
+}
+
+// Newest requests first, at most one render per pool thread at a time
+void TimetableThumbnailModel::startRenders() const
+{
+    while (!queue.isEmpty() && rendersInFlight < renderPool.maxThreadCount()) {
+        const int row = queue.takeLast();
+
+        // Unranking touches the engine memo, so it happens here on the GUI thread
+        QVector<Course> courses = engine->combinationAt(quint64(row));
+        rendersInFlight++;
+
+        auto *self = const_cast<TimetableThumbnailModel *>(this);
+        QtConcurrent::run(&renderPool, [courses]() {
+            TRACE_SCOPE("worker", "thumbnail");
+            return TimetableRenderer::renderImage(courses, ThumbnailDpi);
+        }).then(self, [self, row](const QImage &image) {
+            self->thumbnailReady(row, image);
+        });
+    }
+}
+
+void TimetableThumbnailModel::thumbnailReady(int row, const QImage &image)
+{
+    rendersInFlight--;
+    requested.remove(row);
+    thumbnails.insert(row, new QPixmap(QPixmap::fromImage(image)));
+
+    QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, { Qt::DecorationRole });
+
+    startRenders();
+}
@@ -0,0 +1,74 @@
+/**
+ * TimetableThumbnailModel Header File
+ *
+ * This file defines the list model behind the timetable comparison view.
+ * Each row is one timetable page, shown as a small picture of its grid.
+ */
+
+#ifndef TIMETABLETHUMBNAILMODEL_H
+#define TIMETABLETHUMBNAILMODEL_H
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QPixmap>
+#include <QList>
+#include <QSet>
+#include <QThreadPool>
+
+class TimetableEngine;
+
+/**
+ * TimetableThumbnailModel Class
+ *
+ * Thumbnails are only rendered when a view asks for them (i.e. when they
+ * scroll into sight) and are drawn on a background thread pool. Until
+ * then a placeholder is shown. Finished thumbnails live in an LRU cache.
+ *
+ * Rows are added in chunks as the user scrolls (canFetchMore/fetchMore),
+ * so millions of pages cost nothing until they are looked at.
+ */
+class TimetableThumbnailModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        PageIndexRole = Qt::UserRole + 1  // quint64 page index for a row
+    };
+
+    /**
+     * @param engine: Engine of the TIMETABLE window (must outlive the model)
+     * @param pageCount: Number of pages the engine holds
+     */
+    TimetableThumbnailModel(TimetableEngine *engine, quint64 pageCount, QObject *parent = nullptr);
+    ~TimetableThumbnailModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    /**
+     * Size of one thumbnail image
+     */
+    static QSize thumbnailSize();
+
+private:
+    void requestThumbnail(int row) const;
+    void startRenders() const;
+    void thumbnailReady(int row, const QImage &image);
+
+    TimetableEngine *engine;
+    quint64 pageCount;
+    int loadedRows;
+    QPixmap placeholder;
+
+    // Rendering state changes inside data(), which Qt declares const
+    mutable QCache<int, QPixmap> thumbnails;  // LRU cache of finished thumbnails
+    mutable QList<int> queue;                 // Rows waiting to be rendered, newest last
+    mutable QSet<int> requested;              // Rows queued or being rendered
+    mutable int rendersInFlight;
+    mutable QThreadPool renderPool;
+};
+
+#endif // TIMETABLETHUMBNAILMODEL_H
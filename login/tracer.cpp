@@ -0,0 +1,152 @@
+/**
+ * Tracer Implementation File
+ *
+ * Implements the per-thread event buffers and the JSON trace writer.
+ */
+
+#include "tracer.h"
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QVector>
+#include <QThread>
+#include <QCoreApplication>
+#include <QSaveFile>
+#include <QTextStream>
+
+namespace {
+
+// events kept per thread (32 bytes each, allocated on a thread's first event)
+const int EventsPerThread = 1 << 16;
+
+struct TraceEvent {
+    const char *category;
+    const char *name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+// Written by one thread only; read by stop() up to the published count
+struct ThreadBuffer {
+    QVector<TraceEvent> events;
+    std::atomic<int> used{0};
+    std::atomic<int> dropped{0};
+    int threadId = 0;
+    QString threadName;
+};
+
+QElapsedTimer traceClock;
+QString outputFile;
+QMutex registryMutex;  // Only taken when a thread records its first event
+QVector<QSharedPointer<ThreadBuffer>> registry;
+
+ThreadBuffer *currentBuffer()
+{
+    thread_local ThreadBuffer *buffer = nullptr;  // owned by the registry
+    if (buffer) return buffer;
+
+    QSharedPointer<ThreadBuffer> created(new ThreadBuffer);
+    created->events.resize(EventsPerThread);
+
+    QThread *thread = QThread::currentThread();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+        created->threadName = "main";
+    } else {
+        created->threadName = thread->objectName();
+    }
+
+    QMutexLocker locker(&registryMutex);
+    created->threadId = registry.size() + 1;
+    if (created->threadName != "main") {
+        // pool threads all share one name, so number them
+        created->threadName = QString("%1 %2")
+                                  .arg(created->threadName.isEmpty() ? "thread" : created->threadName)
+                                  .arg(created->threadId);
+    }
+    registry.append(created);
+    buffer = created.data();
+    return buffer;
+}
+
+// ns -> the microseconds trace viewers expect, keeping the fraction
+QString micros(qint64 ns)
+{
+    return QString::number(ns / 1000.0, 'f', 3);
+}
+
+QString jsonText(QString text)
+{
+    return text.replace('\\', "\\\\").replace('"', "\\\"");
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::enabled{false};
+
+void Tracer::start(const QString &fileName)
+{
+    if (isEnabled() || fileName.isEmpty()) return;
+
+    outputFile = fileName;
+    traceClock.start();
+    enabled.store(true, std::memory_order_release);
+}
+
+qint64 Tracer::nowNs()
+{
+    return traceClock.nsecsElapsed();
+}
+
+void Tracer::record(const char *category, const char *name, qint64 startNs, qint64 durationNs)
+{
+    if (!isEnabled()) return;
+
+    ThreadBuffer *buffer = currentBuffer();
+    const int index = buffer->used.load(std::memory_order_relaxed);
+    if (index >= EventsPerThread) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[index] = { category, name, startNs, durationNs };
+    buffer->used.store(index + 1, std::memory_order_release);
+}
+
+// Chrome trace format: complete ("X") events plus one thread_name
+// metadata event per thread
+bool Tracer::stop()
+{
+    if (!isEnabled()) return true;
+    enabled.store(false, std::memory_order_release);
+
+    QSaveFile file(outputFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    QMutexLocker locker(&registryMutex);
+    bool first = true;
+    qint64 dropped = 0;
+    for (const QSharedPointer<ThreadBuffer> &buffer : registry) {
+        out << (first ? "" : ",\n")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+            << ",\"args\":{\"name\":\"" << jsonText(buffer->threadName) << "\"}}";
+        first = false;
+
+        const int used = buffer->used.load(std::memory_order_acquire);
+        for (int i = 0; i < used; ++i) {
+            const TraceEvent &event = buffer->events[i];
+            out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                << "\",\"ph\":\"X\",\"ts\":" << micros(event.startNs)
+                << ",\"dur\":" << micros(event.durationNs)
+                << ",\"pid\":1,\"tid\":" << buffer->threadId << '}';
+        }
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+
+    out << "\n],\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+    out.flush();
+    return file.commit();
+}
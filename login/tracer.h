@@ -0,0 +1,85 @@
+/**
+ * Tracer Header File
+ *
+ * This file defines the opt-in trace recorder. When it is on, timed
+ * spans (engine phases, worker tasks, paints) are written as Chrome
+ * trace events, which chrome://tracing and ui.perfetto.dev can open.
+ *
+ * Turn it on with "--trace <file>" or the TIMETABLE_TRACE environment
+ * variable. When it is off, each TRACE_SCOPE costs one atomic load.
+ */
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <atomic>
+
+/**
+ * Tracer Class
+ *
+ * Every thread records into its own fixed-size buffer, so recording
+ * needs no lock and no allocation. The slot is written first, then the
+ * buffer's event count is published. A full buffer drops new events and
+ * counts them, instead of growing while it is being measured. Buffers
+ * outlive their threads and are all written out by stop().
+ */
+class Tracer {
+public:
+    /**
+     * Starts recording; the file is written by stop()
+     */
+    static void start(const QString &fileName);
+
+    /**
+     * Stops recording and writes the trace file
+     * @return false if tracing was on and the file could not be written
+     */
+    static bool stop();
+
+    static bool isEnabled() { return enabled.load(std::memory_order_acquire); }
+
+    /**
+     * Nanoseconds since start()
+     */
+    static qint64 nowNs();
+
+    /**
+     * Records a span that has already ended (for spans that cross the event
+     * loop, like the loading dialog); names must be string literals
+     */
+    static void record(const char *category, const char *name, qint64 startNs, qint64 durationNs);
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+/**
+ * Records the time from construction to the end of the scope
+ * (only if active, e.g. for one event type in an event() override)
+ */
+class TraceScope {
+public:
+    TraceScope(const char *category, const char *name, bool active = true)
+        : category(category), name(name), startNs(active && Tracer::isEnabled() ? Tracer::nowNs() : -1) {}
+    ~TraceScope()
+    {
+        if (startNs >= 0) Tracer::record(category, name, startNs, Tracer::nowNs() - startNs);
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *category;
+    const char *name;
+    qint64 startNs;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(category, name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name)
+#define TRACE_SCOPE_IF(condition, category, name) \
+    TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name, condition)
+
+#endif // TRACER_H
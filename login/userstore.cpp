@@ -0,0 +1,189 @@
+/**
+ * UserStore Implementation File
+ *
+ * Implements the account file, the student ID index and password hashing.
+ */
+
+#include "userstore.h"
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+
+namespace {
+
+const int HashIterations = 100000;  // cost of one password check (~0.1 s)
+const int SaltSize = 16;
+const int HashSize = 32;            // one SHA-256 block
+
+// The built-in test account (12345 / password123), stored hashed like any other
+const char *const TestStudentID = "12345";
+const char *const TestSalt = "Y291cnNlLXRpbWV0YWJsZQ==";
+const char *const TestHash = "iZ+x0KvZpeDEzXhovN1GI+kkunHZ4TPoB2giTddk/l8=";
+
+// One account per line: student ID, salt, iterations, hash (tab separated,
+// ID/salt/hash base64 encoded so no value can contain a tab or newline)
+QByteArray encodeLine(const QString &studentID, const Credential &credential)
+{
+    return studentID.toUtf8().toBase64() + '\t' + credential.salt.toBase64() + '\t' +
+           QByteArray::number(credential.iterations) + '\t' + credential.hash.toBase64() + '\n';
+}
+
+bool decodeLine(const QByteArray &line, QString &studentID, Credential &credential)
+{
+    const QList<QByteArray> fields = line.trimmed().split('\t');
+    if (fields.size() != 4) return false;
+
+    studentID = QString::fromUtf8(QByteArray::fromBase64(fields[0]));
+    credential.salt = QByteArray::fromBase64(fields[1]);
+    credential.iterations = fields[2].toInt();
+    credential.hash = QByteArray::fromBase64(fields[3]);
+    return !studentID.isEmpty() && credential.isValid();
+}
+
+// compares every byte, so the time taken doesn't show where they differ
+bool constantTimeEquals(const QByteArray &a, const QByteArray &b)
+{
+    if (a.size() != b.size()) return false;
+
+    char difference = 0;
+    for (qsizetype i = 0; i < a.size(); ++i) {
+        difference |= a[i] ^ b[i];
+    }
+    return difference == 0;
+}
+
+} // namespace
+
+UserStore::UserStore()
+    : UserStore(QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation))
+                    .filePath("users.db"))
+{
+}
+
+UserStore::UserStore(const QString &fileName)
+    : fileName(fileName)
+{
+}
+
+bool UserStore::open()
+{
+    users.clear();
+    lastError.clear();
+
+    Credential test;
+    test.salt = QByteArray::fromBase64(TestSalt);
+    test.iterations = HashIterations;
+    test.hash = QByteArray::fromBase64(TestHash);
+
+    QFile file(fileName);
+    if (file.exists()) {
+        if (!file.open(QIODevice::ReadOnly)) {
+            lastError = QString("Cannot read %1").arg(fileName);
+            users.insert(TestStudentID, test);
+            return false;
+        }
+
+        // one pass over the file; a half-written last line is skipped
+        users.reserve(int(file.size() / 96));
+        while (!file.atEnd()) {
+            QString studentID;
+            Credential credential;
+            if (decodeLine(file.readLine(), studentID, credential)) {
+                users.insert(studentID, credential);
+            }
+        }
+    }
+
+    if (!users.contains(TestStudentID)) {
+        users.insert(TestStudentID, test);
+    }
+    return true;
+}
+
+bool UserStore::contains(const QString &studentID) const
+{
+    return users.contains(studentID);
+}
+
+int UserStore::size() const
+{
+    return users.size();
+}
+
+Credential UserStore::credential(const QString &studentID) const
+{
+    return users.value(studentID);
+}
+
+bool UserStore::addUser(const QString &studentID, const Credential &credential)
+{
+    if (users.contains(studentID)) {
+        lastError = "Student ID already exists!";
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    QFile file(fileName);
+    const QByteArray line = encodeLine(studentID, credential);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append) ||
+        file.write(line) != line.size() || !file.flush()) {
+        lastError = QString("Cannot write %1").arg(fileName);
+        return false;
+    }
+
+    users.insert(studentID, credential);
+    return true;
+}
+
+QString UserStore::errorString() const
+{
+    return lastError;
+}
+
+Credential UserStore::makeCredential(const QString &password)
+{
+    Credential credential;
+    credential.salt.resize(SaltSize);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32 *>(credential.salt.data()),
+                                          SaltSize / int(sizeof(quint32)));
+    credential.iterations = HashIterations;
+    credential.hash = pbkdf2(password.toUtf8(), credential.salt, credential.iterations);
+    return credential;
+}
+
+bool UserStore::verify(const Credential &credential, const QString &password)
+{
+    if (!credential.isValid()) {
+        // same amount of work as a real check, then fail
+        pbkdf2(password.toUtf8(), QByteArray(SaltSize, '\0'), HashIterations);
+        return false;
+    }
+
+    return constantTimeEquals(pbkdf2(password.toUtf8(), credential.salt, credential.iterations),
+                              credential.hash);
+}
+
+// PBKDF2 (RFC 8018) with HMAC-SHA256, one output block
+QByteArray UserStore::pbkdf2(const QByteArray &password, const QByteArray &salt, int iterations)
+{
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, password);
+
+    mac.addData(salt);
+    mac.addData(QByteArray("\x00\x00\x00\x01", 4));  // block index 1
+    QByteArray block = mac.result();
+    QByteArray result = block;
+
+    for (int i = 1; i < iterations; ++i) {
+        mac.reset();
+        mac.addData(block);
+        block = mac.result();
+        for (int j = 0; j < HashSize; ++j) {
+            result[j] = char(result[j] ^ block[j]);
+        }
+    }
+    return result;
+}
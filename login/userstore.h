@@ -0,0 +1,97 @@
+/**
+ * UserStore Header File
+ *
+ * This file defines the persistent store of student accounts used by
+ * the login and signup windows.
+ */
+
+#ifndef USERSTORE_H
+#define USERSTORE_H
+
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+
+/**
+ * Credential Structure
+ *
+ * A salted PBKDF2-HMAC-SHA256 password hash. The plain password is
+ * never stored.
+ */
+struct Credential {
+    QByteArray salt;
+    int iterations = 0;
+    QByteArray hash;
+
+    bool isValid() const { return !salt.isEmpty() && iterations > 0 && !hash.isEmpty(); }
+};
+
+/**
+ * UserStore Class
+ *
+ * Accounts are kept in a hash index on student ID (O(1) lookup at any
+ * number of accounts) and in an append-only file: registering writes one
+ * line, the file is never rewritten. The file is read once when the
+ * store is opened.
+ *
+ * Password hashing is deliberately slow (tens of thousands of HMAC
+ * rounds), so makeCredential() and verify() must be called on a worker
+ * thread. They are static and touch no shared state, so that is safe.
+ * Everything else belongs to the GUI thread.
+ */
+class UserStore {
+public:
+    /**
+     * Stores accounts in the application data directory
+     */
+    UserStore();
+
+    /**
+     * @param fileName: Account file (created on the first registration)
+     */
+    explicit UserStore(const QString &fileName);
+
+    /**
+     * Reads the account file into the index
+     * Also adds the built-in test account ("12345") if it isn't there
+     * @return false if the file exists but cannot be read
+     */
+    bool open();
+
+    bool contains(const QString &studentID) const;
+    int size() const;
+
+    /**
+     * Credential of a student; an invalid Credential if there is none
+     */
+    Credential credential(const QString &studentID) const;
+
+    /**
+     * Saves a new account (the credential comes from makeCredential())
+     * @return false if the ID is taken or the file cannot be written
+     */
+    bool addUser(const QString &studentID, const Credential &credential);
+
+    QString errorString() const;
+
+    /**
+     * Hashes a new password with a fresh random salt (slow - worker thread only)
+     */
+    static Credential makeCredential(const QString &password);
+
+    /**
+     * Checks a password against a credential (slow - worker thread only)
+     * An invalid credential is checked against a dummy hash, so unknown
+     * IDs take as long as wrong passwords
+     */
+    static bool verify(const Credential &credential, const QString &password);
+
+private:
+    static QByteArray pbkdf2(const QByteArray &password, const QByteArray &salt, int iterations);
+
+    QString fileName;
+    QHash<QString, Credential> users;  // Index on student ID
+    QString lastError;
+};
+
+#endif // USERSTORE_H